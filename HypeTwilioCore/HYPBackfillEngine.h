@@ -0,0 +1,98 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPBackfillEngineDelegate.h"
+#import "HYPChatBackend.h"
+#import "HYPMessageStore.h"
+
+/**
+ * @abstract Backfill engine.
+ * @discussion This class copies the history of a channel into the message
+ * store. It pages backwards from the newest message, one bounded page at a
+ * time, so the history never has to fit in memory. The index ranges already
+ * fetched are persisted after every page, keyed by the sid of the channel;
+ * a run skips over the ranges of its channel, so an interrupted run resumes
+ * where it stopped and later runs only fetch what is new.
+ */
+@interface HYPBackfillEngine : NSObject
+
+@property (atomic, weak) id<HYPBackfillEngineDelegate> delegate;
+@property (atomic, readonly) id<HYPChatBackend> chatBackend;
+@property (atomic, readonly) HYPMessageStore * messageStore;
+
+/**
+ * @abstract Maximum number of messages per page. Defaults to 100.
+ */
+@property (atomic) NSUInteger pageSize;
+
+/**
+ * @abstract Number of messages of a run flagged as recent. Defaults to 200.
+ * @discussion Only pages fetched one after the other from the newest one
+ * count; once a run skips over history fetched earlier, nothing else it
+ * stores is flagged.
+ */
+@property (atomic) NSUInteger recentWindow;
+
+/**
+ * @abstract Whether a run is in progress.
+ */
+@property (atomic, readonly, getter=isRunning) BOOL running;
+
+/**
+ * @abstract Number of pages fetched.
+ */
+@property (atomic, readonly) NSUInteger fetchedPages;
+
+/**
+ * @abstract Number of messages stored that were not stored before.
+ */
+@property (atomic, readonly) NSUInteger storedMessages;
+
+/**
+ * @abstract Messages stored per second during the last run.
+ */
+@property (atomic, readonly) double throughput;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes an engine that reads from the given backend.
+ * @param chatBackend Backend to read history from.
+ * @param messageStore Store to write history to.
+ * @param cursorPath Path of the file holding the fetched ranges, or nil
+ * not to persist them.
+ */
+- (instancetype)initWithChatBackend:(id<HYPChatBackend>)chatBackend
+                       messageStore:(HYPMessageStore *)messageStore
+                         cursorPath:(NSString *)cursorPath;
+
+/**
+ * @abstract Starts a run.
+ * @discussion This method does nothing if a run is in progress.
+ * @param channel Channel whose history is fetched.
+ */
+- (void)backfillChannel:(id)channel;
+
+@end
@@ -0,0 +1,321 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPBackfillEngine.h"
+#import <sys/resource.h>
+
+static double HYPBackfillPeakResidentMegabytes(void)
+{
+    struct rusage usage;
+    
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    
+    // Darwin reports the peak in bytes, Linux in kilobytes.
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+@interface HYPBackfillEngine ()
+
+@property (atomic, readwrite) id<HYPChatBackend> chatBackend;
+@property (atomic, readwrite) HYPMessageStore * messageStore;
+@property (atomic) NSString * cursorPath;
+@property (strong, atomic, readonly) NSMutableDictionary * fetchedRanges;
+@property (atomic, readwrite, getter=isRunning) BOOL running;
+@property (atomic, readwrite) NSUInteger fetchedPages;
+@property (atomic, readwrite) NSUInteger storedMessages;
+@property (atomic, readwrite) double throughput;
+@property (atomic) NSDate * runDate;
+@property (atomic) NSUInteger runMessages;
+@property (atomic) NSUInteger recentRemaining;
+
+@end
+
+@implementation HYPBackfillEngine
+@synthesize fetchedRanges = _fetchedRanges;
+
+- (instancetype)initWithChatBackend:(id<HYPChatBackend>)chatBackend
+                       messageStore:(HYPMessageStore *)messageStore
+                         cursorPath:(NSString *)cursorPath
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _chatBackend = chatBackend;
+        _messageStore = messageStore;
+        _cursorPath = cursorPath;
+        _fetchedRanges = [NSMutableDictionary new];
+        _pageSize = 100;
+        _recentWindow = 200;
+        
+        [self loadCursor];
+    }
+    
+    return self;
+}
+
+#pragma mark - Cursor
+
+- (void)loadCursor
+{
+    if (self.cursorPath == nil) {
+        return;
+    }
+    
+    NSData * data = [NSData dataWithContentsOfFile:self.cursorPath];
+    
+    if (data == nil) {
+        return;
+    }
+    
+    // Cursors written before ranges were kept per channel hold a bare
+    // array; they are dropped, which only costs refetching those pages.
+    NSDictionary * channels = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    
+    if (![channels isKindOfClass:[NSDictionary class]]) {
+        return;
+    }
+    
+    for (NSString * channelIdentifier in channels) {
+        
+        NSArray * ranges = channels[channelIdentifier];
+        
+        if ([ranges isKindOfClass:[NSArray class]]) {
+            [self.fetchedRanges setObject:[ranges mutableCopy] forKey:channelIdentifier];
+        }
+    }
+}
+
+- (void)saveCursor
+{
+    if (self.cursorPath == nil) {
+        return;
+    }
+    
+    NSData * data = [NSJSONSerialization dataWithJSONObject:self.fetchedRanges options:0 error:nil];
+    [data writeToFile:self.cursorPath atomically:YES];
+}
+
+// Ranges are [lower, upper] index pairs, sorted and disjoint, kept per
+// channel sid since indexes are only meaningful within a channel.
+- (NSMutableArray *)fetchedRangesForChannel:(NSString *)channelIdentifier
+{
+    NSMutableArray * ranges = [self.fetchedRanges objectForKey:channelIdentifier];
+    
+    if (ranges == nil) {
+        ranges = [NSMutableArray new];
+        [self.fetchedRanges setObject:ranges forKey:channelIdentifier];
+    }
+    
+    return ranges;
+}
+
+- (void)addFetchedRangeFrom:(NSUInteger)lower
+                         to:(NSUInteger)upper
+                  inChannel:(NSString *)channelIdentifier
+{
+    NSMutableArray * fetchedRanges = [self fetchedRangesForChannel:channelIdentifier];
+    NSMutableArray * ranges = [NSMutableArray new];
+    
+    for (NSArray * range in fetchedRanges) {
+        
+        NSUInteger rangeLower = [range[0] unsignedIntegerValue];
+        NSUInteger rangeUpper = [range[1] unsignedIntegerValue];
+        
+        // Adjacent ranges merge as well as overlapping ones.
+        if (rangeUpper + 1 < lower || rangeLower > upper + 1) {
+            [ranges addObject:range];
+            continue;
+        }
+        
+        lower = MIN(lower, rangeLower);
+        upper = MAX(upper, rangeUpper);
+    }
+    
+    [ranges addObject:@[@(lower), @(upper)]];
+    [ranges sortUsingComparator:^NSComparisonResult(NSArray * a, NSArray * b) {
+        return [a[0] compare:b[0]];
+    }];
+    
+    [fetchedRanges setArray:ranges];
+}
+
+// Index to page below next, skipping ranges fetched by earlier runs.
+- (NSUInteger)nextIndexBelow:(NSUInteger)index
+                   inChannel:(NSString *)channelIdentifier
+{
+    for (NSArray * range in [self fetchedRangesForChannel:channelIdentifier]) {
+        
+        NSUInteger rangeLower = [range[0] unsignedIntegerValue];
+        NSUInteger rangeUpper = [range[1] unsignedIntegerValue];
+        
+        if (index > rangeLower && index <= rangeUpper + 1) {
+            return rangeLower;
+        }
+    }
+    
+    return index;
+}
+
+#pragma mark - Run
+
+- (void)backfillChannel:(id)channel
+{
+    // The ranges of a channel without a sid could not be told apart from
+    // those of other channels.
+    if ([self.chatBackend identifierForChannel:channel] == nil) {
+        return;
+    }
+    
+    @synchronized(self) {
+        
+        if (self.running) {
+            return;
+        }
+        
+        self.running = YES;
+    }
+    
+    self.runDate = [NSDate date];
+    self.runMessages = 0;
+    self.recentRemaining = self.recentWindow;
+    
+    [self fetchPageFromChannel:channel beforeIndex:nil];
+}
+
+- (void)fetchPageFromChannel:(id)channel
+                 beforeIndex:(NSNumber *)index
+{
+    __weak HYPBackfillEngine * weakSelf = self;
+    
+    [self.chatBackend fetchMessagesFromChannel:channel
+                                   beforeIndex:index
+                                     withCount:self.pageSize
+                                    completion:^(NSArray * messages) {
+                                        
+                                        [weakSelf processPage:messages
+                                                  fromChannel:channel
+                                                  beforeIndex:index];
+                                    }];
+}
+
+- (void)processPage:(NSArray *)messages
+        fromChannel:(id)channel
+        beforeIndex:(NSNumber *)index
+{
+    if (messages == nil) {
+        
+        NSLog(@"Backfill interrupted after %lu messages", (unsigned long)self.runMessages);
+        [self finishComplete:NO];
+        return;
+    }
+    
+    NSString * channelIdentifier = [self.chatBackend identifierForChannel:channel];
+    NSUInteger lower = 0;
+    
+    @autoreleasepool {
+        
+        NSMutableArray * stored = [NSMutableArray new];
+        
+        for (NSDictionary * message in messages) {
+            
+            if ([self.messageStore addMessage:message]) {
+                [stored addObject:message];
+            }
+        }
+        
+        self.fetchedPages++;
+        self.storedMessages += stored.count;
+        self.runMessages += stored.count;
+        
+        // A page covers every index from its oldest message up to the
+        // bound it was asked for, even where messages were deleted.
+        if (messages.count > 0) {
+            
+            lower = [[messages.firstObject objectForKey:@"index"] unsignedIntegerValue];
+            NSUInteger upper = index != nil ? index.unsignedIntegerValue - 1 : [[messages.lastObject objectForKey:@"index"] unsignedIntegerValue];
+            
+            [self addFetchedRangeFrom:lower to:upper inChannel:channelIdentifier];
+            
+        } else if (index != nil && index.unsignedIntegerValue > 0) {
+            
+            [self addFetchedRangeFrom:0 to:index.unsignedIntegerValue - 1 inChannel:channelIdentifier];
+        }
+        
+        [self saveCursor];
+        
+        BOOL recent = self.recentRemaining > 0;
+        self.recentRemaining -= MIN(self.recentRemaining, messages.count);
+        
+        if (stored.count > 0 && [self.delegate respondsToSelector:@selector(backfillEngine:didStoreMessages:recent:)]) {
+            [self.delegate backfillEngine:self didStoreMessages:stored recent:recent];
+        }
+    }
+    
+    NSUInteger next = messages.count > 0 ? [self nextIndexBelow:lower inChannel:channelIdentifier] : 0;
+    
+    // Skipping over history fetched by an earlier run leaves the newest
+    // messages behind; whatever comes below is old, however few messages
+    // this run stored so far.
+    if (next != lower) {
+        self.recentRemaining = 0;
+    }
+    
+    if (next == 0) {
+        [self finishComplete:YES];
+        return;
+    }
+    
+    [self fetchPageFromChannel:channel beforeIndex:@(next)];
+}
+
+- (void)finishComplete:(BOOL)complete
+{
+    NSTimeInterval interval = -[self.runDate timeIntervalSinceNow];
+    self.throughput = interval > 0 ? self.runMessages / interval : 0;
+    
+    if (complete) {
+        NSLog(@"Backfilled %lu messages in %.1fs [%.0f messages/s, %lu pages total, %.1f MB peak resident]",
+              (unsigned long)self.runMessages,
+              interval,
+              self.throughput,
+              (unsigned long)self.fetchedPages,
+              HYPBackfillPeakResidentMegabytes());
+    }
+    
+    self.running = NO;
+    
+    if ([self.delegate respondsToSelector:@selector(backfillEngine:didFinishComplete:)]) {
+        [self.delegate backfillEngine:self didFinishComplete:complete];
+    }
+}
+
+@end
@@ -0,0 +1,61 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @abstract Backfill engine delegate.
+ * @discussion This delegate is told about the history the engine stores,
+ * page by page, and about the end of each run.
+ */
+@class HYPBackfillEngine;
+
+@protocol HYPBackfillEngineDelegate <NSObject>
+
+/**
+ * @abstract Notification issued when a page of history is stored.
+ * @discussion This notification carries only the messages that were not
+ * stored yet. Pages arrive newest first.
+ * @param backfillEngine The engine issuing the notification.
+ * @param messages Messages stored, in ascending index order.
+ * @param recent Whether the messages fall in the recent window of the run.
+ */
+- (void)backfillEngine:(HYPBackfillEngine *)backfillEngine
+      didStoreMessages:(NSArray *)messages
+                recent:(BOOL)recent;
+
+@optional
+
+/**
+ * @abstract Notification issued when a run ends.
+ * @discussion A run ends when the whole history is stored or when a page
+ * fails to be fetched; in the later case the next run resumes from there.
+ * @param backfillEngine The engine issuing the notification.
+ * @param complete Whether the whole history is stored.
+ */
+- (void)backfillEngine:(HYPBackfillEngine *)backfillEngine
+   didFinishComplete:(BOOL)complete;
+
+@end
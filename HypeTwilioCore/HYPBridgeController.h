@@ -0,0 +1,120 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "HYPBackfillEngine.h"
+#import "HYPBridgeControllerDelegate.h"
+#import "HYPMeshControllerDelegate.h"
+#import "HYPChatBackend.h"
+#import "HYPMessageStore.h"
+#import "HYPReliableSender.h"
+#import "HYPTransport.h"
+
+/**
+ * @abstract Bridge controller.
+ * @discussion This controller has the purpose of bridging
+ * two controllers, the twilio controller and hype controller.
+ * The main goal of this bridge controller is to map hype instances
+ * into twilio clients and when new twilio messages arrived, this
+ * controller maps twilio clients into hype instances. The bridge only
+ * depends on Foundation; the transport to offline peers and the chat
+ * backend are handed in by the app or the gateway daemon.
+ */
+@interface HYPBridgeController : NSObject <HYPChatBackendDelegate, HYPMeshControllerDelegate, HYPBackfillEngineDelegate>
+
+@property (atomic, weak) id<HYPBridgeControllerDelegate> delegate;
+
+/**
+ * @abstract Store of the messages seen by the bridge.
+ * @discussion Defaults to a store at the default path. It can be replaced,
+ * for instance to share one store between bridges, before the mesh starts.
+ */
+@property (atomic) HYPMessageStore * messageStore;
+
+/**
+ * @abstract Engine copying the channel history into the message store.
+ * @discussion A run starts whenever this device joins its channel. The most
+ * recent messages of a run are also shown and pushed to offline peers.
+ */
+@property (atomic, readonly) HYPBackfillEngine * backfillEngine;
+
+/**
+ * @abstract Sender of the frames to offline peers.
+ * @discussion Exposed for statistics: goodput, retransmission overhead and
+ * the queueing delays of each priority class.
+ */
+@property (atomic, readonly) HYPReliableSender * reliableSender;
+
+/**
+ * @abstract Number of instances messages are relayed to.
+ */
+@property (atomic, readonly) NSUInteger instanceCount;
+
+/**
+ * @abstract Whether the channel history is backfilled. Defaults to YES.
+ */
+@property (atomic) BOOL backfillsHistory;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a bridge between the given transport and chat backend.
+ * @param identifierForVendor Identifier of this device.
+ * @param transport Transport to offline peers.
+ * @param chatBackend Chat backend to bridge to.
+ */
+- (instancetype)initWithIdentifierForVendor:(NSString *)identifierForVendor
+                                  transport:(id<HYPTransport>)transport
+                                chatBackend:(id<HYPChatBackend>)chatBackend;
+
+/**
+ * @abstract Generates a twilio client.
+ * @discussion This method generates a twilio client.
+ */
+- (void)generateTwilioClient;
+
+/**
+ * @abstract Sends a message to twilio channel.
+ * @discussion This method sends a message to the given twilio channnel.
+ * @param text Message to send.
+ */
+- (void)sendMessageToTwilioWithText:(NSString *)text;
+
+/**
+ * @abstract Requests the mesh to start.
+ * @discussion This method requests the transport to offline peers to start.
+ */
+- (void)requestMeshToStart;
+
+/**
+ * @abstract Sends a message to twilio channel.
+ * @discussion This method sends a message to the given twilio channnel.
+ * @param channel Channel to send.
+ * @param text Message to send.
+ */
+- (void)sendMessageToTwilioToChannel:(id)channel
+                            withText:(NSString *)text;
+
+@end
@@ -0,0 +1,441 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPBridgeController.h"
+#import "HYPMeshController.h"
+#import "HYPInstanceChannel.h"
+
+@interface HYPBridgeController ()
+
+@property (atomic, readonly) id<HYPChatBackend> chatBackend;
+@property (atomic, readonly) HYPMeshController * meshController;
+@property (atomic) NSString * identifierForVendor;
+//@property (atomic) NSString * announcement;
+@property (atomic, readonly) HYPInstanceChannel * instanceChannel;
+@property (strong, atomic, readonly) NSMutableSet * sidContainer;
+@property (strong, atomic, readonly) NSMutableSet * relayedSidContainer;
+@property (strong, atomic, readonly) NSMutableArray * gatewayInstances;
+
+@end
+
+@implementation HYPBridgeController
+@synthesize chatBackend = _chatBackend;
+@synthesize meshController = _meshController;
+@synthesize instanceChannel = _instanceChannel;
+@synthesize sidContainer = _sidContainer;
+@synthesize relayedSidContainer = _relayedSidContainer;
+@synthesize gatewayInstances = _gatewayInstances;
+@synthesize messageStore = _messageStore;
+@synthesize backfillEngine = _backfillEngine;
+
+- (instancetype)initWithIdentifierForVendor:(NSString *)identifierForVendor
+                                  transport:(id<HYPTransport>)transport
+                                chatBackend:(id<HYPChatBackend>)chatBackend
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _identifierForVendor = identifierForVendor;
+        _backfillsHistory = YES;
+        _chatBackend = chatBackend;
+        _chatBackend.delegate = self;
+        _meshController = [[HYPMeshController alloc] initWithTransport:transport
+                                                   identifierForVendor:identifierForVendor];
+        _meshController.delegate = self;
+    }
+    
+    return self;
+}
+
+- (NSMutableSet *)sidContainer
+{
+    @synchronized(self) {
+        
+        if (_sidContainer == nil) {
+            _sidContainer = [NSMutableSet new];
+        }
+        
+        return _sidContainer;
+    }
+}
+
+- (NSMutableSet *)relayedSidContainer
+{
+    @synchronized(self) {
+        
+        if (_relayedSidContainer == nil) {
+            _relayedSidContainer = [NSMutableSet new];
+        }
+        
+        return _relayedSidContainer;
+    }
+}
+
+- (HYPReliableSender *)reliableSender
+{
+    return self.meshController.reliableSender;
+}
+
+- (NSUInteger)instanceCount
+{
+    return self.instanceChannel.instanceIdentifierVendor.count;
+}
+
+- (NSMutableArray *)gatewayInstances
+{
+    @synchronized(self) {
+        
+        if (_gatewayInstances == nil) {
+            _gatewayInstances = [NSMutableArray new];
+        }
+        
+        return _gatewayInstances;
+    }
+}
+
+- (HYPMessageStore *)messageStore
+{
+    @synchronized(self) {
+        
+        if (_messageStore == nil) {
+            _messageStore = [[HYPMessageStore alloc] initWithPath:[HYPMessageStore defaultPath]];
+        }
+        
+        return _messageStore;
+    }
+}
+
+- (void)setMessageStore:(HYPMessageStore *)messageStore
+{
+    @synchronized(self) {
+        _messageStore = messageStore;
+    }
+}
+
+- (HYPBackfillEngine *)backfillEngine
+{
+    @synchronized(self) {
+        
+        if (_backfillEngine == nil) {
+            
+            HYPMessageStore * messageStore = self.messageStore;
+            NSString * cursorPath = [[messageStore.path stringByDeletingPathExtension] stringByAppendingPathExtension:@"cursor"];
+            
+            _backfillEngine = [[HYPBackfillEngine alloc] initWithChatBackend:self.chatBackend
+                                                                messageStore:messageStore
+                                                                  cursorPath:cursorPath];
+            _backfillEngine.delegate = self;
+        }
+        
+        return _backfillEngine;
+    }
+}
+
+- (HYPInstanceChannel *)instanceChannel
+{
+    @synchronized(self) {
+        
+        if (_instanceChannel == nil) {
+            _instanceChannel = [[HYPInstanceChannel alloc] init];
+            
+        }
+        return _instanceChannel;
+    }
+}
+
+- (void)generateTwilioClient
+{
+    [self generateTwilioClientWithIdentifierForVendor:self.identifierForVendor];
+    
+}
+
+- (void) generateTwilioClientWithIdentifierForVendor:(NSString * )identifierForVendor
+{
+    [self.chatBackend generateClientWithIdentifierForVendor:identifierForVendor];
+}
+
+- (void) requestMeshToStart
+{
+    self.meshController.messageStore = self.messageStore;
+    [self.meshController start];
+}
+
+
+#pragma mark - Chat Backend Delegates
+
+// Notification
+- (void)chatBackend:(id<HYPChatBackend>)chatBackend
+     didJoinChannel:(id)channel
+withIdentifierForVendor:(NSString *)identifierForVendor
+           identity:(NSString *)identity
+
+{
+    if([self.identifierForVendor isEqualToString:identifierForVendor]){
+        
+        if ([self.delegate respondsToSelector:@selector(bridgeController:didJoinChannel:withIdentity:)]) {
+            [self.delegate bridgeController:self
+                             didJoinChannel:channel withIdentity:identity];
+        }
+        [self.instanceChannel setChannel:channel forIdentifierVendor:identifierForVendor];
+        [self.meshController didConnect];
+        
+        if (self.backfillsHistory) {
+            [self.backfillEngine backfillChannel:channel];
+        }
+        
+    }else{
+        
+        [self.meshController identifierForVendor:identifierForVendor didjoinChannel:channel withIdentity:identity];
+        [self.instanceChannel setChannel:channel forIdentifierVendor:identifierForVendor];
+    }
+}
+
+- (void)sendMessageToTwilioWithText:(NSString *)text
+{
+    id channel = [self.instanceChannel channelWithIdentifierVendor:self.identifierForVendor];
+    
+    if(channel != nil){
+    
+        [self sendMessageToTwilioToChannel:channel withText:text];
+        
+    }else{
+        
+        // Only a gateway has a channel to post to; any other instance
+        // would acknowledge the message and drop it.
+        id instance = [self.gatewayInstances firstObject] ?: [[self.instanceChannel.instanceIdentifierVendor allValues] firstObject];
+        
+        if (instance == nil) {
+            return;
+        }
+        
+        // The gateway posts through the client it generated for this device,
+        // which is keyed by the device's own identifier.
+        [self.meshController sendMessageToCloserInstance:instance withText: text identifierForVendor:self.identifierForVendor];
+        
+    }
+}
+
+- (void)sendMessageToTwilioToChannel:(id)channel
+                             withText:(NSString *)text
+{
+    [self.chatBackend sendMessageToChannel:channel withText:text];
+}
+
+// Notification
+- (void)chatBackend:(id<HYPChatBackend>)chatBackend
+     didSendMessage:(NSString *)response
+{
+    if ([self.delegate respondsToSelector:@selector(bridgeController:didSendMessage:)]) {
+        [self.delegate bridgeController:self
+                         didSendMessage:response];
+    }
+}
+
+- (void)manageMenssageReceptionsWithReceivedMessage:(NSMutableDictionary *)receivedMessage
+{
+
+    NSString * twilioSid = [receivedMessage objectForKey:@"sid"];
+    BOOL flag = [self.sidContainer containsObject:twilioSid];
+ 
+    if(flag){
+        
+        // Every client joined on behalf of an offline peer receives its own
+        // copy of a message, but peers only need it once.
+        if ([self.relayedSidContainer containsObject:twilioSid]) {
+            return;
+        }
+        
+        [self.relayedSidContainer addObject:twilioSid];
+        NSMutableDictionary * instances = self.instanceChannel.instanceIdentifierVendor;
+        [self.meshController resendTwilioMessage:receivedMessage
+                                     toInstances:instances];
+        
+    }else{
+        
+        [self.sidContainer addObject:twilioSid];
+        [self.messageStore addMessage:receivedMessage];
+        if ([self.delegate respondsToSelector:@selector(bridgeController:didReceiveMessage:)]) {
+            [self.delegate bridgeController:self
+                          didReceiveMessage:receivedMessage];
+        }
+    }
+}
+
+// ReceiveMessageNotification
+- (void)chatBackend:(id<HYPChatBackend>)chatBackend
+  didReceiveMessage:(NSDictionary *)message
+{
+    NSMutableDictionary * receivedMessage = [message mutableCopy];
+    [self manageMenssageReceptionsWithReceivedMessage:receivedMessage];
+}
+
+- (void)chatBackend:(id<HYPChatBackend>)chatBackend
+     failConnecting:(NSString *)response
+{
+    if ([self.delegate respondsToSelector:@selector(bridgeController:failConnecting:)]) {
+        [self.delegate bridgeController:self
+                      failConnecting:@"twilio error"];
+    }
+    [self.meshController failConnecting: response];
+}
+
+#pragma mark - Backfill Engine Delegates
+
+- (void)backfillEngine:(HYPBackfillEngine *)backfillEngine
+      didStoreMessages:(NSArray *)messages
+                recent:(BOOL)recent
+{
+    if ([self.delegate respondsToSelector:@selector(bridgeController:didBackfillMessages:)]) {
+        [self.delegate bridgeController:self
+                    didBackfillMessages:messages];
+    }
+    
+    // Older history stays in the store; peers reach it by reconciling.
+    // Its sids are not tracked here, since it is never shown or relayed.
+    if (!recent) {
+        return;
+    }
+    
+    for (NSDictionary * message in messages) {
+        
+        [self.sidContainer addObject:[message objectForKey:@"sid"]];
+        [self.relayedSidContainer addObject:[message objectForKey:@"sid"]];
+    }
+    
+    [self.meshController pushMessages:messages
+                          toInstances:self.instanceChannel.instanceIdentifierVendor];
+    
+    if ([self.delegate respondsToSelector:@selector(bridgeController:didReceiveMessage:)]) {
+        
+        for (NSDictionary * message in messages) {
+            [self.delegate bridgeController:self
+                          didReceiveMessage:[message mutableCopy]];
+        }
+    }
+}
+
+#pragma mark - Mesh Controller Delegates
+
+- (void)meshController:(HYPMeshController *)meshController
+    requestTwilioClient:(NSString *)identifierForVendor
+{
+    [self generateTwilioClientWithIdentifierForVendor:identifierForVendor];
+}
+
+-(void)meshController:(HYPMeshController *)meshController
+         didJoinTwilio:(NSMutableDictionary *)response
+{
+    if ([self.delegate respondsToSelector:@selector(bridgeController:didJoinTwilio:)]) {
+        [self.delegate bridgeController:self
+                         didJoinTwilio:response];
+    }
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+         didSendMessage:(NSString *)message
+   fromIdentifierVendor:(NSString *)identifierVendor
+{
+    id twilioChannel = [self.instanceChannel channelWithIdentifierVendor:identifierVendor];
+    [self sendMessageToTwilioToChannel:twilioChannel withText:message];
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+       didFoundInstance:(id)instance
+withIdentifierForVendor:(NSString *)identifierForVendor
+{
+    // Keyed by the identifier each instance announced, so that every peer
+    // gets its own entry and is relayed to.
+    [self.instanceChannel setInstance:instance forIdentifierVendor:identifierForVendor];
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+      didReceiveMessage:(NSMutableDictionary *)message
+{
+    [self manageMenssageReceptionsWithReceivedMessage:message];
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+      didRecoverMessage:(NSMutableDictionary *)message
+{
+    // Recovered messages are shown but not relayed; every peer catches up
+    // with its own neighbors.
+    [self.sidContainer addObject:[message objectForKey:@"sid"]];
+    [self.relayedSidContainer addObject:[message objectForKey:@"sid"]];
+    
+    if ([self.delegate respondsToSelector:@selector(bridgeController:didReceiveMessage:)]) {
+        [self.delegate bridgeController:self
+                      didReceiveMessage:message];
+    }
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+        didLoseInstance:(id)instance
+{
+    [self.gatewayInstances removeObject:instance];
+    
+    NSMutableDictionary * dict = self.instanceChannel.instanceIdentifierVendor;
+    NSArray *keys = [dict allKeys];
+    
+    for (int i = 0 ; i < [keys count]; i++)
+    {
+        if ([dict[keys[i]] isEqual:instance])
+        {   
+            [dict removeObjectForKey:keys[i]];
+        }
+    }
+    
+    id channel = [self.instanceChannel channelWithIdentifierVendor:self.identifierForVendor];
+    
+    if([[dict allKeys] count] == 0 && channel == nil ){
+        if ([self.delegate respondsToSelector:@selector(bridgeController:didLoseInstance:)]) {
+            [self.delegate bridgeController:self
+                            didLoseInstance:@"off"];
+        }
+    }
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+        didFindGateway:(id)instance
+{
+    if (![self.gatewayInstances containsObject:instance]) {
+        [self.gatewayInstances addObject:instance];
+    }
+}
+
+- (id)meshController:(HYPMeshController *)meshController
+alternateInstanceForLostInstance:(id)instance
+{
+    for (id candidate in self.gatewayInstances) {
+        
+        if (![candidate isEqual:instance]) {
+            return candidate;
+        }
+    }
+    
+    return nil;
+}
+
+@end
@@ -24,8 +24,6 @@
 //
 
 #import <Foundation/Foundation.h>
-#import "HYPTwilioChannel.h"
-#import "HYPTwilioMessage.h"
 
 /**
  * @abstract Bridge controller delegate.
@@ -33,7 +31,7 @@
  * with twilio controller notifications. This delegate notifys upper classes
  * when some client joined a channel, a message was sent to twilio with
  * success, a new message arrived, if a client fails connecting to twilio
- * and Hype framework loses an instance.
+ * and the mesh loses an instance.
  */
 @class HYPBridgeController;
 
@@ -48,7 +46,7 @@
  * @param identity Identity of the device that joined the channel.
  */
 - (void)bridgeController:(HYPBridgeController *)bridgeController
-          didJoinChannel:(HYPTwilioChannel *)channel
+          didJoinChannel:(id)channel
             withIdentity:(NSString *)identity;
 
 /**
@@ -97,4 +95,15 @@
  */
 - (void)bridgeController:(HYPBridgeController *)bridgeController
           didLoseInstance:(NSString *)response;
+
+/**
+ * @abstract Notification issued when history is copied into the store.
+ * @discussion This notification indicates that a page of channel history
+ * was stored. Unlike received messages, most of it is never shown, so this
+ * is where anything following the store catches up with it.
+ * @param bridgeController The controller issuing the notification.
+ * @param messages Messages stored.
+ */
+- (void)bridgeController:(HYPBridgeController *)bridgeController
+     didBackfillMessages:(NSArray *)messages;
 @end
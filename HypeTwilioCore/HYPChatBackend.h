@@ -0,0 +1,80 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPChatBackendDelegate.h"
+
+/**
+ * @abstract Chat backend.
+ * @discussion This protocol abstracts the chat service the bridge posts to.
+ * The app implements it with the Twilio SDK and the gateway daemon with a
+ * local stand-in. Channels are opaque objects owned by the backend.
+ */
+@protocol HYPChatBackend <NSObject>
+
+@property (atomic, weak) id<HYPChatBackendDelegate> delegate;
+
+/**
+ * @abstract Generates a client.
+ * @discussion This method generates a chat client with the given identifier
+ * and joins it to the default channel.
+ * @param identifierForVendor The identifier to assign.
+ */
+- (void)generateClientWithIdentifierForVendor:(NSString *)identifierForVendor;
+
+/**
+ * @abstract Sends a message to a channel.
+ * @discussion This method sends a message to the given channel.
+ * @param channel Channel to send.
+ * @param text Message to send.
+ */
+- (void)sendMessageToChannel:(id)channel
+                    withText:(NSString *)text;
+
+/**
+ * @abstract Identifier of a channel.
+ * @discussion This method returns the service's identifier for the given
+ * channel, which stays the same across clients and launches.
+ * @param channel Channel to identify.
+ */
+- (NSString *)identifierForChannel:(id)channel;
+
+/**
+ * @abstract Fetches a page of channel history.
+ * @discussion This method fetches the newest messages of the channel whose
+ * index is below the given one. Messages are dictionaries with the same
+ * keys as the ones received live, index and timestamp included.
+ * @param channel Channel to read.
+ * @param index Exclusive upper bound of the page, or nil for the newest page.
+ * @param count Maximum number of messages in the page.
+ * @param completion Called with the page in ascending index order, or with
+ * nil if the page could not be fetched.
+ */
+- (void)fetchMessagesFromChannel:(id)channel
+                     beforeIndex:(NSNumber *)index
+                       withCount:(NSUInteger)count
+                      completion:(void (^)(NSArray * messages))completion;
+
+@end
@@ -24,60 +24,59 @@
 //
 
 #import <Foundation/Foundation.h>
-#import "HYPTwilioChannel.h"
-#import "HYPTwilioMessage.h"
 
 /**
- * @abstract Twilio controller delegate.
- * @discussion This controller delegate has the purpose of dealing
- * with twilio controller notifications. This delegate notifys upper classes
- * when some client joined a channel, a message was sent to twilio with
- * success, a new message arrived or if a client fails connecting to twilio.
+ * @abstract Chat backend delegate.
+ * @discussion This delegate has the purpose of dealing with chat backend
+ * notifications. This delegate notifys upper classes when some client
+ * joined a channel, a message was sent with success, a new message
+ * arrived or if a client fails connecting.
  */
-@class HYPTwilioController;
+@protocol HYPChatBackend;
 
-@protocol HYPTwilioControllerDelegate <NSObject>
+@protocol HYPChatBackendDelegate <NSObject>
 
 /**
  * @abstract Notification issued when identifier for vendor joins a channel.
  * @discussion This notification indicates that the given identifier for vendor
  * joined a channel with the given identity.
- * @param twilioController The controller issuing the notification.
+ * @param chatBackend The backend issuing the notification.
  * @param channel Channel that has been joined.
  * @param identifierForVendor Identifier for Vendor of the device joined.
  * @param identity Identity of the device that joined the channel.
  */
-- (void)twilioController:(HYPTwilioController *)twilioController
-          didJoinChannel:(HYPTwilioChannel *)channel
- withIdentifierForVendor:(NSString *)identifierForVendor
-             identity:(NSString *)identity;
+- (void)chatBackend:(id<HYPChatBackend>)chatBackend
+     didJoinChannel:(id)channel
+withIdentifierForVendor:(NSString *)identifierForVendor
+           identity:(NSString *)identity;
 
 /**
  * @abstract Notification issued when a client sends a message.
- * @discussion This notification indicates that the message was 
+ * @discussion This notification indicates that the message was
  * sent with success.
- * @param twilioController The controller issuing the notification.
- * @param response Feedback given by twilio.
+ * @param chatBackend The backend issuing the notification.
+ * @param response Feedback given by the backend.
  */
-- (void)twilioController:(HYPTwilioController *)twilioController
-          didSendMessage:(NSString *)response;
+- (void)chatBackend:(id<HYPChatBackend>)chatBackend
+     didSendMessage:(NSString *)response;
 
 /**
- * @abstract Notification issued when twilio channel has a new message.
+ * @abstract Notification issued when a channel has a new message.
  * @discussion This notification indicates that the channel has a new message.
- * @param twilioController The controller issuing the notification.
+ * The message holds the "sid", "author" and "body" keys.
+ * @param chatBackend The backend issuing the notification.
  * @param message Message received.
  */
-- (void)twilioController:(HYPTwilioController *)twilioController
-       didReceiveMessage:(HYPTwilioMessage *)message;
+- (void)chatBackend:(id<HYPChatBackend>)chatBackend
+  didReceiveMessage:(NSDictionary *)message;
 
 /**
- * @abstract Notification issued when fails connecting to twilio channel.
- * @discussion This notification indicates that client could not join twilio channel.
- * @param twilioController The controller issuing the notification.
+ * @abstract Notification issued when fails connecting to a channel.
+ * @discussion This notification indicates that client could not join the channel.
+ * @param chatBackend The backend issuing the notification.
  * @param response Indicates a message describing the why it failed.
  */
-- (void)twilioController:(HYPTwilioController *)twilioController
-          failConnecting:(NSString *)response;
+- (void)chatBackend:(id<HYPChatBackend>)chatBackend
+     failConnecting:(NSString *)response;
 
 @end
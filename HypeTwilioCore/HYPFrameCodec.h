@@ -0,0 +1,53 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @abstract Frame codec.
+ * @discussion This class turns frames into bytes and back. Frames are JSON
+ * objects. Bulky frames, such as batches of history, can be deflated, in
+ * which case the bytes start with a marker that never starts a JSON object.
+ */
+@interface HYPFrameCodec : NSObject
+
+/**
+ * @abstract Encodes a frame.
+ * @param frame Frame to encode.
+ * @param compressed Whether to deflate the encoded frame.
+ * @return Bytes to send, or nil if the frame cannot be encoded.
+ */
++ (NSData *)dataWithFrame:(NSDictionary *)frame
+               compressed:(BOOL)compressed;
+
+/**
+ * @abstract Decodes a frame.
+ * @discussion This method accepts both plain and deflated frames.
+ * @param data Bytes received.
+ * @return Frame decoded, or nil if the bytes are not a frame.
+ */
++ (NSMutableDictionary *)frameWithData:(NSData *)data;
+
+@end
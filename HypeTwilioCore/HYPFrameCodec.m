@@ -0,0 +1,102 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPFrameCodec.h"
+#import <zlib.h>
+
+// Marker of deflated frames, followed by the inflated length and the
+// zlib stream.
+static const uint8_t HYPFrameCodecDeflated = 'Z';
+static const size_t HYPFrameCodecHeaderLength = 5;
+
+// Inflated frames above this length are rejected.
+static const uLong HYPFrameCodecMaximumLength = 16 * 1024 * 1024;
+
+@implementation HYPFrameCodec
+
++ (NSData *)dataWithFrame:(NSDictionary *)frame
+               compressed:(BOOL)compressed
+{
+    NSData * data = [NSJSONSerialization dataWithJSONObject:frame
+                                                    options:0
+                                                      error:nil];
+    
+    if (data == nil || !compressed) {
+        return data;
+    }
+    
+    uLong length = compressBound((uLong)data.length);
+    NSMutableData * deflated = [NSMutableData dataWithLength:HYPFrameCodecHeaderLength + length];
+    uint8_t * bytes = deflated.mutableBytes;
+    uint32_t inflatedLength = NSSwapHostIntToBig((unsigned int)data.length);
+    
+    bytes[0] = HYPFrameCodecDeflated;
+    memcpy(bytes + 1, &inflatedLength, sizeof(inflatedLength));
+    
+    if (compress2(bytes + HYPFrameCodecHeaderLength, &length, data.bytes, (uLong)data.length, Z_BEST_SPEED) != Z_OK) {
+        return data;
+    }
+    
+    // Sending the plain frame is cheaper when deflate does not pay off.
+    if (HYPFrameCodecHeaderLength + length >= data.length) {
+        return data;
+    }
+    
+    [deflated setLength:HYPFrameCodecHeaderLength + length];
+    
+    return deflated;
+}
+
++ (NSMutableDictionary *)frameWithData:(NSData *)data
+{
+    if (data.length > HYPFrameCodecHeaderLength && ((const uint8_t *)data.bytes)[0] == HYPFrameCodecDeflated) {
+        
+        uint32_t inflatedLength;
+        memcpy(&inflatedLength, (const uint8_t *)data.bytes + 1, sizeof(inflatedLength));
+        
+        uLong length = NSSwapBigIntToHost(inflatedLength);
+        
+        if (length > HYPFrameCodecMaximumLength) {
+            return nil;
+        }
+        
+        NSMutableData * inflated = [NSMutableData dataWithLength:length];
+        
+        if (uncompress(inflated.mutableBytes, &length, (const uint8_t *)data.bytes + HYPFrameCodecHeaderLength, (uLong)(data.length - HYPFrameCodecHeaderLength)) != Z_OK) {
+            return nil;
+        }
+        
+        [inflated setLength:length];
+        data = inflated;
+    }
+    
+    id frame = [NSJSONSerialization JSONObjectWithData:data
+                                               options:NSJSONReadingMutableContainers
+                                                 error:nil];
+    
+    return [frame isKindOfClass:[NSDictionary class]] ? frame : nil;
+}
+
+@end
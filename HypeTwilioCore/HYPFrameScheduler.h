@@ -0,0 +1,116 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPOutboundFrame.h"
+
+/**
+ * @abstract Frame scheduler.
+ * @discussion This class holds frames waiting for a send window. Each peer
+ * has one queue per priority class, and a peer always serves its highest
+ * class first unless a lower class has waited longer than the starvation
+ * interval. Peers share the link by deficit round robin, weighted per peer,
+ * so a burst to one peer does not delay frames to the others.
+ */
+@interface HYPFrameScheduler : NSObject
+
+/**
+ * @abstract Bytes credited to a peer of weight one on each round.
+ */
+@property (atomic) NSUInteger quantum;
+
+/**
+ * @abstract Waiting time after which a frame is served ahead of higher classes.
+ */
+@property (atomic) NSTimeInterval starvationInterval;
+
+/**
+ * @abstract Number of frames waiting in all queues.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ * @abstract Queues a frame.
+ * @discussion This method appends the frame to its peer's queue for the
+ * frame's priority class.
+ * @param frame Frame to queue.
+ * @param peerIdentifier Identifier of the destination peer.
+ */
+- (void)enqueueFrame:(HYPOutboundFrame *)frame
+   forPeerIdentifier:(NSString *)peerIdentifier;
+
+/**
+ * @abstract Queues a frame for retransmission.
+ * @discussion This method puts the frame ahead of the frames of its class
+ * that were never sent.
+ * @param frame Frame to queue.
+ * @param peerIdentifier Identifier of the destination peer.
+ */
+- (void)requeueFrame:(HYPOutboundFrame *)frame
+   forPeerIdentifier:(NSString *)peerIdentifier;
+
+/**
+ * @abstract Takes the next frame to transmit.
+ * @discussion This method picks the next frame among the classes and peers
+ * accepted by the given test, or nil if none of them has frames.
+ * @param eligible Test telling whether a peer's send window is open to a
+ * frame of the given class.
+ */
+- (HYPOutboundFrame *)dequeueFrameForPeersPassingTest:(BOOL (^)(NSString * peerIdentifier, HYPFramePriority priority))eligible;
+
+/**
+ * @abstract Removes the frames of a peer.
+ * @discussion This method empties all queues of the given peer.
+ * @param peerIdentifier Identifier of the peer.
+ * @return Frames removed, highest class first.
+ */
+- (NSArray *)removeFramesForPeerIdentifier:(NSString *)peerIdentifier;
+
+/**
+ * @abstract Sets the share of a peer.
+ * @discussion A peer of weight two is served twice the bytes of a peer of
+ * weight one when both have frames waiting. The default weight is one.
+ * @param weight Weight of the peer.
+ * @param peerIdentifier Identifier of the peer.
+ */
+- (void)setWeight:(NSUInteger)weight
+forPeerIdentifier:(NSString *)peerIdentifier;
+
+/**
+ * @abstract Number of frames of a class that left the queues.
+ */
+- (NSUInteger)dequeuedFramesWithPriority:(HYPFramePriority)priority;
+
+/**
+ * @abstract Mean time frames of a class waited in the queues.
+ */
+- (NSTimeInterval)averageQueueingDelayForPriority:(HYPFramePriority)priority;
+
+/**
+ * @abstract Longest time a frame of a class waited in the queues.
+ */
+- (NSTimeInterval)maximumQueueingDelayForPriority:(HYPFramePriority)priority;
+
+@end
@@ -0,0 +1,293 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPFrameScheduler.h"
+
+@interface HYPFrameScheduler ()
+
+@property (strong, atomic, readonly) NSMutableDictionary * queues;
+@property (strong, atomic, readonly) NSMutableDictionary * deficits;
+@property (strong, atomic, readonly) NSMutableDictionary * weights;
+@property (strong, atomic, readonly) NSMutableArray * activePeers;
+@property (atomic) NSUInteger roundRobinIndex;
+@property (atomic, readwrite) NSUInteger count;
+
+@end
+
+@implementation HYPFrameScheduler
+{
+    NSUInteger _dequeuedFrames[HYPFramePriorityCount];
+    NSTimeInterval _totalDelay[HYPFramePriorityCount];
+    NSTimeInterval _maximumDelay[HYPFramePriorityCount];
+}
+
+@synthesize queues = _queues;
+@synthesize deficits = _deficits;
+@synthesize weights = _weights;
+@synthesize activePeers = _activePeers;
+
+- (instancetype)init
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _queues = [NSMutableDictionary new];
+        _deficits = [NSMutableDictionary new];
+        _weights = [NSMutableDictionary new];
+        _activePeers = [NSMutableArray new];
+        _quantum = 4096;
+        _starvationInterval = 2.0;
+    }
+    
+    return self;
+}
+
+#pragma mark - Queues
+
+- (NSArray *)queuesForPeerIdentifier:(NSString *)peerIdentifier
+{
+    NSArray * queues = [self.queues objectForKey:peerIdentifier];
+    
+    if (queues == nil) {
+        
+        NSMutableArray * classes = [NSMutableArray new];
+        
+        for (NSUInteger priority = 0; priority < HYPFramePriorityCount; priority++) {
+            [classes addObject:[NSMutableArray new]];
+        }
+        
+        queues = classes;
+        [self.queues setObject:queues forKey:peerIdentifier];
+        [self.activePeers addObject:peerIdentifier];
+    }
+    
+    return queues;
+}
+
+- (void)enqueueFrame:(HYPOutboundFrame *)frame
+   forPeerIdentifier:(NSString *)peerIdentifier
+{
+    @synchronized(self) {
+        
+        frame.enqueueDate = [NSDate date];
+        [[[self queuesForPeerIdentifier:peerIdentifier] objectAtIndex:frame.priority] addObject:frame];
+        self.count += 1;
+    }
+}
+
+- (void)requeueFrame:(HYPOutboundFrame *)frame
+   forPeerIdentifier:(NSString *)peerIdentifier
+{
+    @synchronized(self) {
+        
+        frame.enqueueDate = [NSDate date];
+        [[[self queuesForPeerIdentifier:peerIdentifier] objectAtIndex:frame.priority] insertObject:frame atIndex:0];
+        self.count += 1;
+    }
+}
+
+- (void)forgetPeerIdentifier:(NSString *)peerIdentifier
+{
+    NSUInteger index = [self.activePeers indexOfObject:peerIdentifier];
+    
+    if (index != NSNotFound) {
+        
+        [self.activePeers removeObjectAtIndex:index];
+        
+        if (index < self.roundRobinIndex) {
+            self.roundRobinIndex -= 1;
+        }
+    }
+    
+    [self.queues removeObjectForKey:peerIdentifier];
+    [self.deficits removeObjectForKey:peerIdentifier];
+}
+
+- (NSArray *)removeFramesForPeerIdentifier:(NSString *)peerIdentifier
+{
+    @synchronized(self) {
+        
+        NSMutableArray * frames = [NSMutableArray new];
+        
+        for (NSMutableArray * queue in [self.queues objectForKey:peerIdentifier]) {
+            [frames addObjectsFromArray:queue];
+        }
+        
+        self.count -= frames.count;
+        [self forgetPeerIdentifier:peerIdentifier];
+        
+        return frames;
+    }
+}
+
+- (void)setWeight:(NSUInteger)weight
+forPeerIdentifier:(NSString *)peerIdentifier
+{
+    @synchronized(self) {
+        [self.weights setObject:@(MAX(weight, 1)) forKey:peerIdentifier];
+    }
+}
+
+#pragma mark - Scheduling
+
+- (NSMutableArray *)nextQueueInQueues:(NSArray *)queues
+                                  now:(NSDate *)now
+                          passingTest:(BOOL (^)(HYPFramePriority priority))eligible
+{
+    NSMutableArray * next = nil;
+    NSDate * oldest = nil;
+    
+    for (NSUInteger priority = 0; priority < queues.count; priority++) {
+        
+        NSMutableArray * queue = [queues objectAtIndex:priority];
+        
+        // Classes whose window is closed do not hold the others back.
+        if (queue.count == 0 || (eligible != nil && !eligible(priority))) {
+            continue;
+        }
+        
+        HYPOutboundFrame * head = [queue objectAtIndex:0];
+        
+        if (next == nil) {
+            
+            // Highest class with frames waiting.
+            next = queue;
+            oldest = head.enqueueDate;
+            
+        } else if ([now timeIntervalSinceDate:head.enqueueDate] > self.starvationInterval
+                   && [head.enqueueDate compare:oldest] == NSOrderedAscending) {
+            
+            // A lower class that waited too long goes first, so that a
+            // steady stream of control frames cannot hold history forever.
+            next = queue;
+            oldest = head.enqueueDate;
+        }
+    }
+    
+    return next;
+}
+
+- (HYPOutboundFrame *)dequeueFrameForPeersPassingTest:(BOOL (^)(NSString * peerIdentifier, HYPFramePriority priority))eligible
+{
+    @synchronized(self) {
+        
+        NSDate * now = [NSDate date];
+        
+        // Deficit round robin. Every visit to a peer that cannot afford its
+        // next frame credits it a quantum and moves on, so a pass in which
+        // some peer was eligible always brings that peer closer to sending.
+        while (self.activePeers.count > 0) {
+            
+            BOOL sawEligiblePeer = NO;
+            NSUInteger visits = self.activePeers.count;
+            
+            for (NSUInteger visit = 0; visit < visits; visit++) {
+                
+                if (self.roundRobinIndex >= self.activePeers.count) {
+                    self.roundRobinIndex = 0;
+                }
+                
+                NSString * peerIdentifier = [self.activePeers objectAtIndex:self.roundRobinIndex];
+                NSMutableArray * queue = [self nextQueueInQueues:[self.queues objectForKey:peerIdentifier]
+                                                             now:now
+                                                     passingTest:^BOOL(HYPFramePriority priority) {
+                                                         return eligible(peerIdentifier, priority);
+                                                     }];
+                
+                if (queue == nil) {
+                    self.roundRobinIndex += 1;
+                    continue;
+                }
+                
+                sawEligiblePeer = YES;
+                
+                HYPOutboundFrame * frame = [queue objectAtIndex:0];
+                NSUInteger cost = MAX(frame.data.length, 1);
+                NSUInteger deficit = [[self.deficits objectForKey:peerIdentifier] unsignedIntegerValue];
+                
+                if (deficit < cost) {
+                    
+                    NSUInteger weight = MAX([[self.weights objectForKey:peerIdentifier] unsignedIntegerValue], 1);
+                    [self.deficits setObject:@(deficit + self.quantum * weight) forKey:peerIdentifier];
+                    self.roundRobinIndex += 1;
+                    continue;
+                }
+                
+                [queue removeObjectAtIndex:0];
+                self.count -= 1;
+                [self.deficits setObject:@(deficit - cost) forKey:peerIdentifier];
+                [self recordDelay:[now timeIntervalSinceDate:frame.enqueueDate] priority:frame.priority];
+                
+                // A peer that ran out of frames leaves the round and loses its
+                // credit, as in deficit round robin; otherwise it keeps its
+                // turn while the credit lasts.
+                if ([self nextQueueInQueues:[self.queues objectForKey:peerIdentifier] now:now passingTest:nil] == nil) {
+                    [self forgetPeerIdentifier:peerIdentifier];
+                }
+                
+                return frame;
+            }
+            
+            if (!sawEligiblePeer) {
+                break;
+            }
+        }
+        
+        return nil;
+    }
+}
+
+#pragma mark - Metrics
+
+- (void)recordDelay:(NSTimeInterval)delay priority:(HYPFramePriority)priority
+{
+    _dequeuedFrames[priority] += 1;
+    _totalDelay[priority] += delay;
+    _maximumDelay[priority] = MAX(_maximumDelay[priority], delay);
+}
+
+- (NSUInteger)dequeuedFramesWithPriority:(HYPFramePriority)priority
+{
+    @synchronized(self) {
+        return _dequeuedFrames[priority];
+    }
+}
+
+- (NSTimeInterval)averageQueueingDelayForPriority:(HYPFramePriority)priority
+{
+    @synchronized(self) {
+        return _dequeuedFrames[priority] > 0 ? _totalDelay[priority] / _dequeuedFrames[priority] : 0;
+    }
+}
+
+- (NSTimeInterval)maximumQueueingDelayForPriority:(HYPFramePriority)priority
+{
+    @synchronized(self) {
+        return _maximumDelay[priority];
+    }
+}
+
+@end
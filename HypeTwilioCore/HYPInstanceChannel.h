@@ -24,14 +24,13 @@
 //
 
 #import <Foundation/Foundation.h>
-#import "HYPTwilioChannel.h"
-#import <Hype/Hype.h>
 
 /**
  * @abstract Twilio instance channel.
  * @discussion This class maps Hype instances with idenfiers for vendor
- * and HYPTwilioChannels with identifiers for vendor, so we can
- * associate hype instances with twilio channels.
+ * and twilio channels with identifiers for vendor, so we can
+ * associate hype instances with twilio channels. Instances and channels
+ * are the opaque peers and channels of the transport and chat backend.
  */
 @interface HYPInstanceChannel : NSObject
 
@@ -43,34 +42,34 @@
 
 /**
  * @abstract Setter.
- * @discussion Sets an HYPInstance object with a given identifier vendor.
- * @param instance HYPInstance object received.
+ * @discussion Sets an instance object with a given identifier vendor.
+ * @param instance Instance object received.
  * @param identifierVendor Identifier for vendor received.
  */
-- (void)setInstance:(HYPInstance *)instance
+- (void)setInstance:(id)instance
 forIdentifierVendor:(NSString *)identifierVendor;
 
 /**
  * @abstract Setter.
- * @discussion Sets an HYPTwilioChannel object with a given identifier vendor.
- * @param channel HYPTwilioChannel object received.
+ * @discussion Sets a channel object with a given identifier vendor.
+ * @param channel Channel object received.
  * @param identifierVendor Identifier for vendor received.
  */
-- (void)setChannel:(HYPTwilioChannel *)channel
+- (void)setChannel:(id)channel
 forIdentifierVendor:(NSString *)identifierVendor;
 
 /**
  * @abstract Getter.
- * @discussion Gets an HYPInstance object with a given identifier vendor.
+ * @discussion Gets an instance object with a given identifier vendor.
  * @param identifierVendor Identifier for vendor received.
  */
-- (HYPInstance *)instanceWithIdentifierVendor:(NSString *)identifierVendor;
+- (id)instanceWithIdentifierVendor:(NSString *)identifierVendor;
 
 /**
  * @abstract Getter.
- * @discussion Gets an HYPTwilioChannel object with a given identifier vendor.
+ * @discussion Gets a channel object with a given identifier vendor.
  * @param identifierVendor Identifier for vendor received.
  */
-- (HYPTwilioChannel *)channelWithIdentifierVendor:(NSString *)identifierVendor;
+- (id)channelWithIdentifierVendor:(NSString *)identifierVendor;
 
 @end
@@ -60,29 +60,29 @@
     }
 }
 
-- (void)setInstance:(HYPInstance *)instance
+- (void)setInstance:(id)instance
 forIdentifierVendor:(NSString *)identifierVendor
 {
     [self.instanceIdentifierVendor setValue:instance forKey:identifierVendor];
 }
 
-- (void)setChannel:(HYPTwilioChannel *)channel
+- (void)setChannel:(id)channel
 forIdentifierVendor:(NSString *)identifierVendor
 {
     [self.channelIdentifierVendor setValue:channel forKey:identifierVendor];
 }
 
-- (HYPInstance *)instanceWithIdentifierVendor:(NSString *)identifierVendor
+- (id)instanceWithIdentifierVendor:(NSString *)identifierVendor
 {
-    HYPInstance * instance = [self.instanceIdentifierVendor objectForKey:identifierVendor];
+    id instance = [self.instanceIdentifierVendor objectForKey:identifierVendor];
     
     return instance;
 
 }
 
-- (HYPTwilioChannel *) channelWithIdentifierVendor:(NSString *)identifierVendor
+- (id) channelWithIdentifierVendor:(NSString *)identifierVendor
 {
-    HYPTwilioChannel * channel = [self.channelIdentifierVendor objectForKey:identifierVendor];
+    id channel = [self.channelIdentifierVendor objectForKey:identifierVendor];
     
     return channel;
 }
@@ -0,0 +1,143 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPMeshControllerDelegate.h"
+#import "HYPMessageStore.h"
+#import "HYPReliableSender.h"
+#import "HYPTransport.h"
+
+/**
+ * @abstract Mesh controller.
+ * @discussion This controller speaks the bridge protocol with offline peers
+ * over a transport. The main responsabilities of this controller are:
+ * announce the device to new peers, join an offline peer to a twilio
+ * channel, send messages to a closer instance and foward messages from
+ * twilio to closer instances. Every frame goes through a reliable sender,
+ * so it is retransmitted until the transport confirms its delivery.
+ * When a peer is found, both ends reconcile their message stores by
+ * exchanging fingerprints of sid ranges, splitting the ranges that differ
+ * until they are small enough to list, so only the missing messages travel.
+ * The end with the lower identifier for vendor starts the exchange.
+ */
+@interface HYPMeshController : NSObject <HYPTransportDelegate>
+
+@property (atomic, weak) id<HYPMeshControllerDelegate> delegate;
+@property (atomic, readonly) id<HYPTransport> transport;
+
+/**
+ * @abstract Sender every frame goes through.
+ * @discussion Its counters and its scheduler's queueing delays describe
+ * the traffic to offline peers.
+ */
+@property (atomic, readonly) HYPReliableSender * reliableSender;
+
+/**
+ * @abstract Store reconciled with peers. Must be set before starting.
+ */
+@property (atomic) HYPMessageStore * messageStore;
+
+/**
+ * @abstract Bytes of reconciliation frames sent, messages included.
+ */
+@property (atomic, readonly) NSUInteger reconciliationBytes;
+
+/**
+ * @abstract Number of messages recovered from peers.
+ */
+@property (atomic, readonly) NSUInteger recoveredMessages;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a controller that talks over the given transport.
+ * @param transport Transport to offline peers.
+ * @param identifierForVendor Identifier announced to peers.
+ */
+- (instancetype)initWithTransport:(id<HYPTransport>)transport
+              identifierForVendor:(NSString *)identifierForVendor;
+
+/**
+ * @abstract Requests the transport to start.
+ * @discussion This method requests the transport to start.
+ */
+- (void)start;
+
+/**
+ * @abstract Notification issued when identifier for vendor joins a channel.
+ * @discussion This notification indicates that the given identifier for vendor
+ * joined a channel with the given identity.
+ * @param channel Channel that has been joined.
+ * @param identifierForVendor Identifier for vendor of the device joined.
+ * @param identity Identity of the device that joined the channel.
+ */
+- (void)identifierForVendor:(NSString *)identifierForVendor
+             didjoinChannel:(id)channel
+               withIdentity:(NSString *)identity;
+
+/**
+ * @abstract Sends a message to instance.
+ * @discussion This method sends a message to a given instance.
+ * @param instance Instance that will receive the message.
+ * @param text Message to send.
+ * @param identifierForVendor Peer identifier for vendor.
+ */
+- (void)sendMessageToCloserInstance:(id)instance
+                           withText:(NSString *)text
+                identifierForVendor:(NSString *)identifierForVendor;
+
+/**
+ * @abstract Forwards messages to saved instances.
+ * @discussion This method fowards a messages to saved instances.
+ * @param message Message that will be foward
+ * @param instances Saved instances.
+ */
+- (void)resendTwilioMessage:(NSMutableDictionary *)message
+                toInstances:(NSDictionary *)instances;
+
+/**
+ * @abstract Notifys class that it joined twilio.
+ * @discussion This method makes the device announce itself as a gateway,
+ * including to the peers it already found.
+ */
+- (void)didConnect;
+
+/**
+ * @abstract Pushes stored messages to instances.
+ * @discussion This method sends the messages to every instance in deflated
+ * batch frames at backfill priority, so they never delay live traffic.
+ * @param messages Messages to push.
+ * @param instances Instances that will receive the messages.
+ */
+- (void)pushMessages:(NSArray *)messages
+         toInstances:(NSDictionary *)instances;
+
+/**
+ * @abstract Notifys class that it fails trying to connect to twilio.
+ * @discussion This method notifys class when it fails trying to connect to twilio.
+ * @param response Error response
+ */
+- (void)failConnecting:(NSString *)response;
+
+@end
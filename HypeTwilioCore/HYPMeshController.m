@@ -0,0 +1,854 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPMeshController.h"
+#import "HYPFrameCodec.h"
+#import "HYPInstanceChannel.h"
+#import "HYPReliableSender.h"
+
+// Ranges holding up to this many sids are listed instead of fingerprinted.
+static const NSUInteger HYPReconciliationListThreshold = 16;
+
+// Number of subranges a differing range is split into.
+static const NSUInteger HYPReconciliationBranching = 4;
+
+// Byte budget of the items packed in one reconciliation frame, before
+// deflate. It keeps every frame well below the largest UDP datagram.
+static const NSUInteger HYPReconciliationFrameLength = 16384;
+
+// Share of the link given to a gateway, which carries the sends of every
+// offline peer behind this device.
+static const NSUInteger HYPGatewayPeerWeight = 2;
+
+// Number of frame nonces remembered for deduplication.
+static const NSUInteger HYPReceivedNoncesCapacity = 4096;
+
+// Frames come from the network, so every field is checked against the
+// class the handlers expect before they touch it.
+static BOOL HYPIsKindOfClass(id value, Class class, BOOL optional)
+{
+    return value == nil ? optional : [value isKindOfClass:class];
+}
+
+static BOOL HYPIsArrayOfClass(id value, Class class)
+{
+    if (![value isKindOfClass:[NSArray class]]) {
+        return NO;
+    }
+
+    for (id object in value) {
+        if (![object isKindOfClass:class]) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+@interface HYPMeshController () <HYPReliableSenderDelegate>
+
+@property (atomic, readwrite) id<HYPTransport> transport;
+@property (atomic) NSString * identifierForVendor;
+@property (atomic, readonly) HYPInstanceChannel * instanceChannel;
+@property (strong, atomic, readonly) NSMutableOrderedSet * receivedNonces;
+@property (strong, atomic, readonly) NSMutableDictionary * peers;
+@property (strong, atomic, readonly) NSMutableSet * syncedPeers;
+@property (atomic) NSString * announcement;
+@property (nonatomic, assign) BOOL netAccess;
+@property (atomic, readwrite) NSUInteger reconciliationBytes;
+@property (atomic, readwrite) NSUInteger recoveredMessages;
+
+@end
+
+@implementation HYPMeshController
+@synthesize transport = _transport;
+@synthesize instanceChannel = _instanceChannel;
+@synthesize reliableSender = _reliableSender;
+@synthesize receivedNonces = _receivedNonces;
+@synthesize peers = _peers;
+@synthesize syncedPeers = _syncedPeers;
+
+- (instancetype)initWithTransport:(id<HYPTransport>)transport
+              identifierForVendor:(NSString *)identifierForVendor
+{
+    self = [super init];
+
+    if (self) {
+
+        _transport = transport;
+        _transport.delegate = self;
+        _identifierForVendor = identifierForVendor;
+    }
+
+    return self;
+}
+
+- (HYPInstanceChannel *)instanceChannel
+{
+
+    @synchronized(self) {
+
+        if (_instanceChannel == nil) {
+            _instanceChannel = [[HYPInstanceChannel alloc] init];
+
+        }
+        return _instanceChannel;
+    }
+}
+
+- (HYPReliableSender *)reliableSender
+{
+    @synchronized(self) {
+
+        if (_reliableSender == nil) {
+            _reliableSender = [[HYPReliableSender alloc] initWithQueue:self.transport.queue];
+            _reliableSender.delegate = self;
+        }
+        return _reliableSender;
+    }
+}
+
+- (NSMutableOrderedSet *)receivedNonces
+{
+    @synchronized(self) {
+
+        if (_receivedNonces == nil) {
+            _receivedNonces = [NSMutableOrderedSet new];
+        }
+        return _receivedNonces;
+    }
+}
+
+- (NSMutableDictionary *)peers
+{
+    @synchronized(self) {
+
+        if (_peers == nil) {
+            _peers = [NSMutableDictionary new];
+        }
+        return _peers;
+    }
+}
+
+- (NSMutableSet *)syncedPeers
+{
+    @synchronized(self) {
+
+        if (_syncedPeers == nil) {
+            _syncedPeers = [NSMutableSet new];
+        }
+        return _syncedPeers;
+    }
+}
+
+- (void)start
+{
+    [self.transport start];
+}
+
+#pragma mark - Transport
+
+- (void)transport:(id<HYPTransport>)transport
+      didFindPeer:(id)peer
+{
+    [self.peers setObject:peer forKey:[self.transport identifierForPeer:peer]];
+    [self sendResponseToResolvedInstance:peer];
+}
+
+- (void)transport:(id<HYPTransport>)transport
+      didLosePeer:(id)peer
+{
+    [self.peers removeObjectForKey:[self.transport identifierForPeer:peer]];
+    [self.syncedPeers removeObject:[self.transport identifierForPeer:peer]];
+    [self notifiyMeshControllerOnInstanceLost:peer];
+
+    // Frames still waiting for the lost instance are moved to another
+    // gateway when possible. This happens after the bridge forgot the
+    // instance so it is never picked as its own replacement.
+    [self.reliableSender didLosePeer:peer];
+}
+
+- (void)transport:(id<HYPTransport>)transport
+   didReceiveData:(NSData *)data
+         fromPeer:(id)peer
+{
+    NSMutableDictionary *response = [HYPFrameCodec frameWithData:data];
+
+    if (![self isValidFrame:response]) {
+        NSLog(@"Dropping malformed frame from %@", [self.transport identifierForPeer:peer]);
+        return;
+    }
+
+    // Retransmitted copies of a frame whose delivery notification got
+    // lost are discarded before any processing.
+    if (![self acceptNonce:[response objectForKey:@"nonce"]]) {
+        return;
+    }
+
+    // Instances are only reported once they announce their identifier, so
+    // the bridge can tell every peer apart.
+    if ([[response objectForKey:@"type"] isEqualToString:@"announcement"]) {
+        [self notifiyMeshControllerOnInstanceResolved:peer vendorIdentifier:[response objectForKey:@"vendorIdentifier"]];
+        [self startReconciliationWithPeer:peer vendorIdentifier:[response objectForKey:@"vendorIdentifier"]];
+    }
+
+    if ([[response objectForKey:@"type"] isEqualToString:@"announcement"] && [[response objectForKey:@"twilio"] isEqualToString:@"NO"]){
+
+        [self proccessAnnouncementResponsesWithDictionary:response instance:peer];
+
+    }else if ([[response objectForKey:@"type"] isEqualToString:@"announcement"] && [[response objectForKey:@"twilio"] isEqualToString:@"YES"]){
+
+        [self.reliableSender.scheduler setWeight:HYPGatewayPeerWeight
+                               forPeerIdentifier:[self.transport identifierForPeer:peer]];
+        [self notifiyMeshControllerOnGatewayFound:peer];
+
+    }else if ([[response objectForKey:@"type"] isEqualToString:@"client"]){
+
+        [self processClientWithResponse:response];
+
+    }else if ([[response objectForKey:@"type"] isEqualToString:@"send"]){
+
+        [self processSendsWithResponse:response];
+
+    }else if ([[response objectForKey:@"type"] isEqualToString:@"receive"]){
+
+        [self processReceivesWithResponse:response];
+
+    }else if ([[response objectForKey:@"type"] isEqualToString:@"sync"]){
+
+        [self processSyncWithResponse:response fromPeer:peer];
+
+    }else if ([[response objectForKey:@"type"] isEqualToString:@"want"]){
+
+        [self sendMessagesWithSids:[response objectForKey:@"sids"] toPeer:peer];
+
+    }else if ([[response objectForKey:@"type"] isEqualToString:@"batch"]){
+
+        [self processBatchWithResponse:response fromPeer:peer];
+    }
+}
+
+- (void)transport:(id<HYPTransport>)transport
+didDeliverMessageWithIdentifier:(NSUInteger)identifier
+{
+    [self.reliableSender didDeliverMessageWithIdentifier:identifier];
+}
+
+- (void)transport:(id<HYPTransport>)transport
+didFailSendingMessageWithIdentifier:(NSUInteger)identifier
+{
+    [self.reliableSender didFailSendingMessageWithIdentifier:identifier];
+}
+
+#pragma mark - Frames
+
+- (void)sendMessageToCloserInstance:(id)instance
+                           withText:(NSString *)text
+                identifierForVendor:(NSString *)identifierForVendor
+{
+    NSMutableDictionary * sendMessage = [[NSMutableDictionary alloc] init];
+    [sendMessage setValue:text forKey:@"message"];
+    [sendMessage setValue:@"send" forKey:@"type"];
+    [sendMessage setValue:identifierForVendor forKey:@"identifierForVendor"];
+
+    [self sendFrame:sendMessage
+             toPeer:instance
+           priority:HYPFramePriorityInteractive
+       retargetable:YES
+         compressed:NO];
+}
+
+- (void)sendMessage:(NSMutableDictionary* )twilioMessage
+         toInstance:(id)instance
+{
+    NSMutableDictionary * dict = [twilioMessage mutableCopy];
+    if([dict objectForKey:@"type"] == nil)
+    {
+        [dict setValue:@"receive" forKey:@"type"];
+    }
+
+    [self sendFrame:dict
+             toPeer:instance
+           priority:HYPFramePriorityRelay
+       retargetable:NO
+         compressed:NO];
+}
+
+- (void)processSendsWithResponse:(NSMutableDictionary *)response
+{
+    if ([self.delegate respondsToSelector:@selector(meshController:didSendMessage:fromIdentifierVendor:)]) {
+
+        [self.delegate meshController:self didSendMessage:[response objectForKey:@"message"] fromIdentifierVendor:[response objectForKey:@"identifierForVendor"]];
+
+    }
+}
+
+- (void)resendTwilioMessage:(NSMutableDictionary *)message
+                toInstances:(NSDictionary *)instances
+{
+
+    for (NSString* key in instances) {
+
+        id instance = [instances objectForKey:key];
+        [self sendMessage:message toInstance:instance];
+
+    }
+}
+
+- (void) processReceivesWithResponse:(NSMutableDictionary *)response
+{
+    if ([self.delegate respondsToSelector:@selector(meshController:didReceiveMessage:)]) {
+
+        [self.delegate meshController:self didReceiveMessage:response];
+
+    }
+}
+
+#pragma mark - Notify bridge
+
+- (void)identifierForVendor:(NSString *)identifierForVendor
+             didjoinChannel:(id)channel
+               withIdentity:(NSString *)identity
+{
+    id instance = [self.instanceChannel instanceWithIdentifierVendor:identifierForVendor];
+    [self.instanceChannel setChannel:channel forIdentifierVendor:identifierForVendor];
+    NSMutableDictionary * channelDict = [[NSMutableDictionary alloc]init];
+    [channelDict setValue:@"client"forKey:@"type"];
+    [channelDict setValue:identity forKey:@"identity"];
+
+    [self sendFrame:channelDict
+             toPeer:instance
+           priority:HYPFramePriorityControl
+       retargetable:NO
+         compressed:NO];
+}
+
+#pragma mark - Mesh Manager
+
+- (void)proccessAnnouncementResponsesWithDictionary:(NSMutableDictionary *)response
+                                           instance:(id)instance
+{
+    if ([self.delegate respondsToSelector:@selector(meshController:requestTwilioClient:)]) {
+
+        [self.instanceChannel setInstance:instance forIdentifierVendor:[response objectForKey:@"vendorIdentifier"]];
+
+        [self.delegate meshController:self requestTwilioClient:[response objectForKey:@"vendorIdentifier"]];
+
+    }
+}
+
+- (void)processClientWithResponse:(NSMutableDictionary * )response
+{
+    self.announcement = @"MIM";
+
+    if ([self.delegate respondsToSelector:@selector(meshController:didJoinTwilio:)]) {
+
+        [self.delegate meshController:self didJoinTwilio:response];
+
+    }
+}
+
+- (void)failConnecting:(NSString *)response
+{
+    self.netAccess = false;
+}
+
+- (void)didConnect
+{
+    self.netAccess = true;
+
+    // Peers found before the device got online were told otherwise.
+    for (id peer in [self.peers allValues]) {
+        [self sendResponseToResolvedInstance:peer];
+    }
+}
+
+-(void)sendResponseToResolvedInstance:(id)instance
+{
+    NSMutableDictionary *response = [[NSMutableDictionary alloc] init];
+    [response setValue:@"announcement" forKey:@"type"];
+
+    if(self.netAccess){
+        [response setValue:@"YES" forKey:@"twilio"];
+    }else{
+        [response setValue:@"NO" forKey:@"twilio"];
+    }
+
+    [response setValue:self.identifierForVendor forKey:@"vendorIdentifier"];
+
+    [self sendFrame:response
+             toPeer:instance
+           priority:HYPFramePriorityControl
+       retargetable:NO
+         compressed:NO];
+}
+
+-(void)notifiyMeshControllerOnInstanceResolved:(id)instance
+                               vendorIdentifier:(NSString *)vendorIdentifier
+{
+    if ([self.delegate respondsToSelector:@selector(meshController:didFoundInstance:withIdentifierForVendor:)]) {
+        [self.delegate meshController:self didFoundInstance:instance withIdentifierForVendor:vendorIdentifier];
+    }
+}
+
+-(void)notifiyMeshControllerOnGatewayFound:(id)instance
+{
+    if ([self.delegate respondsToSelector:@selector(meshController:didFindGateway:)]) {
+        [self.delegate meshController:self didFindGateway:instance];
+    }
+}
+
+-(void)notifiyMeshControllerOnInstanceLost:(id)instance
+{
+    if ([self.delegate respondsToSelector:@selector(meshController:didLoseInstance:)]) {
+
+        [self.delegate meshController:self didLoseInstance:instance ];
+
+    }
+}
+
+#pragma mark - Reconciliation
+
+- (void)startReconciliationWithPeer:(id)peer
+                   vendorIdentifier:(NSString *)vendorIdentifier
+{
+    // Only the end with the lower identifier starts, once per encounter;
+    // if both did, every missing message would be sent twice.
+    if ([self.identifierForVendor compare:vendorIdentifier options:NSLiteralSearch] != NSOrderedAscending) {
+        return;
+    }
+
+    NSString * peerIdentifier = [self.transport identifierForPeer:peer];
+
+    @synchronized(self.syncedPeers) {
+
+        if ([self.syncedPeers containsObject:peerIdentifier]) {
+            return;
+        }
+
+        [self.syncedPeers addObject:peerIdentifier];
+    }
+
+    [self sendSyncToPeer:peer];
+}
+
+- (void)sendSyncToPeer:(id)peer
+{
+    if (self.messageStore == nil) {
+        return;
+    }
+
+    NSDictionary * range = [self rangeFromSid:nil toSid:nil];
+
+    [self sendReconciliationFrame:@{ @"type" : @"sync", @"ranges" : @[range] }
+                           toPeer:peer
+                       compressed:NO];
+}
+
+- (NSDictionary *)rangeFromSid:(NSString *)lowerSid
+                         toSid:(NSString *)upperSid
+{
+    NSMutableDictionary * range = [[NSMutableDictionary alloc] init];
+    [range setValue:lowerSid forKey:@"lower"];
+    [range setValue:upperSid forKey:@"upper"];
+
+    NSUInteger count = 0;
+    uint64_t fingerprint = [self.messageStore fingerprintFromSid:lowerSid toSid:upperSid count:&count];
+
+    // Small ranges are listed, which ends the recursion on the other side.
+    if (count <= HYPReconciliationListThreshold) {
+        [range setValue:[self.messageStore sidsFromSid:lowerSid toSid:upperSid] forKey:@"sids"];
+    } else {
+        [range setValue:[NSString stringWithFormat:@"%016llx", (unsigned long long)fingerprint] forKey:@"fingerprint"];
+        [range setValue:@(count) forKey:@"count"];
+    }
+
+    return range;
+}
+
+- (void)processSyncWithResponse:(NSMutableDictionary *)response
+                       fromPeer:(id)peer
+{
+    if (self.messageStore == nil) {
+        return;
+    }
+
+    NSMutableArray * replies = [NSMutableArray new];
+    NSMutableArray * wanted = [NSMutableArray new];
+    NSMutableArray * offered = [NSMutableArray new];
+
+    for (NSDictionary * range in [response objectForKey:@"ranges"]) {
+
+        NSString * lowerSid = [range objectForKey:@"lower"];
+        NSString * upperSid = [range objectForKey:@"upper"];
+        NSArray * theirSids = [range objectForKey:@"sids"];
+        NSArray * ourSids = [self.messageStore sidsFromSid:lowerSid toSid:upperSid];
+
+        // A listed range is settled right away: ask for what we lack and
+        // offer what the peer lacks.
+        if (theirSids != nil) {
+
+            NSSet * theirSet = [NSSet setWithArray:theirSids];
+
+            for (NSString * sid in theirSids) {
+                if (![self.messageStore containsMessageWithSid:sid]) {
+                    [wanted addObject:sid];
+                }
+            }
+
+            for (NSString * sid in ourSids) {
+                if (![theirSet containsObject:sid]) {
+                    [offered addObject:sid];
+                }
+            }
+
+            continue;
+        }
+
+        NSUInteger count = 0;
+        uint64_t fingerprint = [self.messageStore fingerprintFromSid:lowerSid toSid:upperSid count:&count];
+        NSString * ourFingerprint = [NSString stringWithFormat:@"%016llx", (unsigned long long)fingerprint];
+
+        if (count == [[range objectForKey:@"count"] unsignedIntegerValue] && [ourFingerprint isEqualToString:[range objectForKey:@"fingerprint"]]) {
+            continue;
+        }
+
+        if (ourSids.count <= HYPReconciliationListThreshold) {
+
+            [replies addObject:[self rangeFromSid:lowerSid toSid:upperSid]];
+            continue;
+        }
+
+        // Split on our own sids, so each subrange holds a fraction of them.
+        NSString * boundary = lowerSid;
+
+        for (NSUInteger i = 1; i <= HYPReconciliationBranching; i++) {
+
+            NSString * next = upperSid;
+
+            if (i < HYPReconciliationBranching) {
+                next = ourSids[i * ourSids.count / HYPReconciliationBranching];
+            }
+
+            [replies addObject:[self rangeFromSid:boundary toSid:next]];
+            boundary = next;
+        }
+    }
+
+    [self sendReconciliationFramesOfType:@"sync"
+                                     key:@"ranges"
+                                   items:replies
+                                  toPeer:peer
+                              compressed:NO];
+
+    [self sendReconciliationFramesOfType:@"want"
+                                     key:@"sids"
+                                   items:wanted
+                                  toPeer:peer
+                              compressed:NO];
+
+    [self sendMessagesWithSids:offered toPeer:peer];
+}
+
+- (void)sendMessagesWithSids:(NSArray *)sids
+                      toPeer:(id)peer
+{
+    [self sendMessages:[self.messageStore messagesWithSids:sids] toPeer:peer];
+}
+
+- (void)pushMessages:(NSArray *)messages
+         toInstances:(NSDictionary *)instances
+{
+    for (NSString * key in instances) {
+
+        [self sendMessages:messages toPeer:[instances objectForKey:key]];
+
+    }
+}
+
+- (void)sendMessages:(NSArray *)messages
+              toPeer:(id)peer
+{
+    [self sendReconciliationFramesOfType:@"batch"
+                                     key:@"messages"
+                                   items:messages
+                                  toPeer:peer
+                              compressed:YES];
+}
+
+- (void)sendReconciliationFramesOfType:(NSString *)type
+                                   key:(NSString *)key
+                                 items:(NSArray *)items
+                                toPeer:(id)peer
+                            compressed:(BOOL)compressed
+{
+    NSMutableArray * chunk = [NSMutableArray new];
+    NSUInteger length = 0;
+
+    for (id item in items) {
+
+        NSUInteger itemLength = [NSJSONSerialization dataWithJSONObject:@[item] options:0 error:nil].length;
+
+        if (chunk.count > 0 && length + itemLength > HYPReconciliationFrameLength) {
+
+            [self sendReconciliationFrame:@{ @"type" : type, key : chunk }
+                                   toPeer:peer
+                               compressed:compressed];
+            chunk = [NSMutableArray new];
+            length = 0;
+        }
+
+        [chunk addObject:item];
+        length += itemLength;
+    }
+
+    if (chunk.count > 0) {
+        [self sendReconciliationFrame:@{ @"type" : type, key : chunk }
+                               toPeer:peer
+                           compressed:compressed];
+    }
+}
+
+- (void)processBatchWithResponse:(NSMutableDictionary *)response
+                        fromPeer:(id)peer
+{
+    NSUInteger recovered = 0;
+
+    for (NSDictionary * message in [response objectForKey:@"messages"]) {
+
+        if (![self.messageStore addMessage:message]) {
+            continue;
+        }
+
+        recovered++;
+
+        if ([self.delegate respondsToSelector:@selector(meshController:didRecoverMessage:)]) {
+
+            [self.delegate meshController:self didRecoverMessage:[message mutableCopy]];
+
+        }
+    }
+
+    self.recoveredMessages += recovered;
+
+    if (recovered == 0) {
+        return;
+    }
+
+    NSLog(@"Recovered %lu messages from %@ [%lu reconciliation bytes sent]",
+          (unsigned long)recovered,
+          [self.transport identifierForPeer:peer],
+          (unsigned long)self.reconciliationBytes);
+}
+
+- (void)sendReconciliationFrame:(NSDictionary *)frame
+                         toPeer:(id)peer
+                     compressed:(BOOL)compressed
+{
+    self.reconciliationBytes += [self sendFrame:frame
+                                         toPeer:peer
+                                       priority:HYPFramePriorityBackfill
+                                   retargetable:NO
+                                     compressed:compressed];
+}
+
+#pragma mark - Validation
+
+- (BOOL)isValidFrame:(NSDictionary *)frame
+{
+    NSString * type = [frame objectForKey:@"type"];
+
+    if (!HYPIsKindOfClass(type, [NSString class], NO)
+        || !HYPIsKindOfClass([frame objectForKey:@"nonce"], [NSString class], YES)) {
+        return NO;
+    }
+
+    if ([type isEqualToString:@"announcement"]) {
+
+        return HYPIsKindOfClass([frame objectForKey:@"twilio"], [NSString class], NO)
+            && HYPIsKindOfClass([frame objectForKey:@"vendorIdentifier"], [NSString class], NO);
+
+    } else if ([type isEqualToString:@"client"]) {
+
+        return HYPIsKindOfClass([frame objectForKey:@"identity"], [NSString class], YES);
+
+    } else if ([type isEqualToString:@"send"]) {
+
+        return HYPIsKindOfClass([frame objectForKey:@"message"], [NSString class], NO)
+            && HYPIsKindOfClass([frame objectForKey:@"identifierForVendor"], [NSString class], NO);
+
+    } else if ([type isEqualToString:@"receive"]) {
+
+        return [self isValidMessage:frame];
+
+    } else if ([type isEqualToString:@"sync"]) {
+
+        NSArray * ranges = [frame objectForKey:@"ranges"];
+
+        if (!HYPIsArrayOfClass(ranges, [NSDictionary class])) {
+            return NO;
+        }
+
+        for (NSDictionary * range in ranges) {
+            if (![self isValidRange:range]) {
+                return NO;
+            }
+        }
+
+    } else if ([type isEqualToString:@"want"]) {
+
+        return HYPIsArrayOfClass([frame objectForKey:@"sids"], [NSString class]);
+
+    } else if ([type isEqualToString:@"batch"]) {
+
+        NSArray * messages = [frame objectForKey:@"messages"];
+
+        if (!HYPIsArrayOfClass(messages, [NSDictionary class])) {
+            return NO;
+        }
+
+        for (NSDictionary * message in messages) {
+            if (![self isValidMessage:message]) {
+                return NO;
+            }
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)isValidRange:(NSDictionary *)range
+{
+    NSArray * sids = [range objectForKey:@"sids"];
+
+    if (!HYPIsKindOfClass([range objectForKey:@"lower"], [NSString class], YES)
+        || !HYPIsKindOfClass([range objectForKey:@"upper"], [NSString class], YES)) {
+        return NO;
+    }
+
+    // A range either lists its sids or summarizes them.
+    if (sids != nil) {
+        return HYPIsArrayOfClass(sids, [NSString class]);
+    }
+
+    return HYPIsKindOfClass([range objectForKey:@"fingerprint"], [NSString class], NO)
+        && HYPIsKindOfClass([range objectForKey:@"count"], [NSNumber class], NO);
+}
+
+- (BOOL)isValidMessage:(NSDictionary *)message
+{
+    return HYPIsKindOfClass([message objectForKey:@"sid"], [NSString class], NO)
+        && HYPIsKindOfClass([message objectForKey:@"author"], [NSString class], YES)
+        && HYPIsKindOfClass([message objectForKey:@"body"], [NSString class], YES)
+        && HYPIsKindOfClass([message objectForKey:@"index"], [NSNumber class], YES)
+        && HYPIsKindOfClass([message objectForKey:@"timestamp"], [NSNumber class], YES);
+}
+
+#pragma mark - Deduplication
+
+- (NSUInteger)sendFrame:(NSDictionary *)frame
+                 toPeer:(id)peer
+               priority:(HYPFramePriority)priority
+           retargetable:(BOOL)retargetable
+             compressed:(BOOL)compressed
+{
+    // Every frame gets its own nonce, which lets the receiver discard
+    // copies that were retransmitted after the delivery notification got
+    // lost. Relayed messages get a new one, since each hop is a new frame.
+    NSMutableDictionary * nonced = [frame mutableCopy];
+    [nonced setValue:[[NSUUID UUID] UUIDString] forKey:@"nonce"];
+
+    NSData * data = [HYPFrameCodec dataWithFrame:nonced
+                                      compressed:compressed];
+
+    [self.reliableSender sendData:data
+                           toPeer:peer
+                         priority:priority
+                     retargetable:retargetable];
+
+    return data.length;
+}
+
+- (BOOL)acceptNonce:(NSString *)nonce
+{
+    // Frames from older versions carry no nonce and are let through.
+    if (nonce == nil) {
+        return YES;
+    }
+
+    @synchronized(self.receivedNonces) {
+
+        if ([self.receivedNonces containsObject:nonce]) {
+            return NO;
+        }
+
+        [self.receivedNonces addObject:nonce];
+
+        if (self.receivedNonces.count > HYPReceivedNoncesCapacity) {
+            [self.receivedNonces removeObjectAtIndex:0];
+        }
+    }
+
+    return YES;
+}
+
+#pragma mark - Reliable sender
+
+- (NSUInteger)reliableSender:(HYPReliableSender *)reliableSender
+                transmitData:(NSData *)data
+                      toPeer:(id)peer
+{
+    return [self.transport sendData:data toPeer:peer];
+}
+
+- (NSString *)reliableSender:(HYPReliableSender *)reliableSender
+           identifierForPeer:(id)peer
+{
+    return [self.transport identifierForPeer:peer];
+}
+
+- (id)reliableSender:(HYPReliableSender *)reliableSender
+alternatePeerForLostPeer:(id)peer
+{
+    if ([self.delegate respondsToSelector:@selector(meshController:alternateInstanceForLostInstance:)]) {
+
+        return [self.delegate meshController:self alternateInstanceForLostInstance:peer];
+
+    }
+
+    return nil;
+}
+
+- (void)reliableSender:(HYPReliableSender *)reliableSender
+           didDropData:(NSData *)data
+                toPeer:(id)peer
+{
+    NSLog(@"Gave up sending frame to %@ [goodput %.1f B/s, overhead %.2f]",
+          [self.transport identifierForPeer:peer],
+          reliableSender.goodput,
+          reliableSender.retransmissionOverhead);
+}
+
+@end
@@ -23,78 +23,111 @@
 // SOFTWARE.
 //
 
-#import <Hype/Hype.h>
+#import <Foundation/Foundation.h>
 
 /**
- * @abstract Hype controller delegate.
+ * @abstract Mesh controller delegate.
  * @discussion This controller delegate has the purpose of dealing
- * with hype controller notifications. This delegate notifys upper classes
+ * with mesh controller notifications. This delegate notifys upper classes
  * when it neeeds to request a twilio client, needs to join a offline peer
  * to a twilio channel, needs to foward a message from a offline peer to twilio,
  * when founds or loses a new peer.
  */
-@class HYPHypeController;
+@class HYPMeshController;
 
-@protocol HYPHypeControllerDelegate <NSObject>
+@protocol HYPMeshControllerDelegate <NSObject>
 
 /**
  * @abstract Notification issued when a twilio client request occur.
  * @discussion This notification indicates that a offline peer 
  * wants do connect to twilio. So
- * @param hypeController The controller issuing the notification.
+ * @param meshController The controller issuing the notification.
  * @param identifierForVendor Indicates the identifier vendor of the offline client.
  */
-- (void)hypeController:(HYPHypeController *)hypeController
+- (void)meshController:(HYPMeshController *)meshController
    requestTwilioClient:(NSString *)identifierForVendor;
 
 /**
  * @abstract Notification issued when identifier for vendor joins a channel.
  * @discussion This notification indicates that the given identifier for vendor
  * joined a channel with the given identity.
- * @param hypeController The controller issuing the notification.
+ * @param meshController The controller issuing the notification.
  * @param response Channel that has been joined.
  */
-- (void)hypeController:(HYPHypeController *)hypeController
+- (void)meshController:(HYPMeshController *)meshController
          didJoinTwilio:(NSMutableDictionary *)response;
 /**
  * @abstract Notification issued to send messages to twilio.
  * @discussion This notification occurs when a client fowards a message
  * to twilio from a offline client.
- * @param hypeController The controller issuing the notification.
+ * @param meshController The controller issuing the notification.
  * @param instance Indicates the instance of the offline client.
  * @param identifierVendor Indicates the identifier vendor of the offline client.
  */
-- (void) hypeController:(HYPHypeController *)hypeController
+- (void) meshController:(HYPMeshController *)meshController
          didSendMessage:(NSString *)instance
    fromIdentifierVendor:(NSString *)identifierVendor;
 
 /**
- * @abstract Notification issued to indicate that hype found an instance.
- * @discussion This notification occurs when the hype framework found an instance.
- * @param hypeController The controller issuing the notification.
+ * @abstract Notification issued to indicate that the mesh found an instance.
+ * @discussion This notification occurs when an instance found by the
+ * transport announces itself, and again whenever it announces a change.
+ * @param meshController The controller issuing the notification.
  * @param instance Indicates the instance of the offline client.
- * @param identifierForVendor Indicates the identifier vendor of the offline client.
+ * @param identifierForVendor Indicates the identifier vendor the instance announced.
  */
-- (void)hypeController:(HYPHypeController *)hypeController
-       didFoundInstance:(HYPInstance *)instance
+- (void)meshController:(HYPMeshController *)meshController
+       didFoundInstance:(id)instance
 withIdentifierForVendor:(NSString *) identifierForVendor;
 
+/**
+ * @abstract Notification issued when an instance announces it is online.
+ * @discussion This notification indicates that the instance has its own
+ * twilio client, so it can forward messages on behalf of this device.
+ * @param meshController The controller issuing the notification.
+ * @param instance Instance of the gateway.
+ */
+- (void)meshController:(HYPMeshController *)meshController
+        didFindGateway:(id)instance;
+
 /**
  * @abstract Notification issued when loses a instance.
  * @discussion This notification indicates that client could not join twilio channel.
- * @param hypeController The controller issuing the notification.
+ * @param meshController The controller issuing the notification.
  * @param instance Indicates a message describing the why it failed.
  */
-- (void)hypeController:(HYPHypeController * )hypeController
-        didLoseInstance:(HYPInstance *)instance;
+- (void)meshController:(HYPMeshController * )meshController
+        didLoseInstance:(id)instance;
 
 /**
- * @abstract Notification issued hype framework receives message.
- * @discussion This notification indicates that hype framework received a message.
- * @param hypeController The controller issuing the notification.
+ * @abstract Notification issued the mesh receives a message.
+ * @discussion This notification indicates that the mesh received a message.
+ * @param meshController The controller issuing the notification.
  * @param message Message received.
  */
-- (void)hypeController:(HYPHypeController *)hypeController
+- (void)meshController:(HYPMeshController *)meshController
       didReceiveMessage:(NSMutableDictionary *)message;
 
+/**
+ * @abstract Notification issued when a missing message is recovered.
+ * @discussion This notification indicates that a peer sent a message that
+ * was missing from the store while reconciling. The message is already
+ * stored, and it is not relayed further.
+ * @param meshController The controller issuing the notification.
+ * @param message Message recovered.
+ */
+- (void)meshController:(HYPMeshController *)meshController
+     didRecoverMessage:(NSMutableDictionary *)message;
+
+/**
+ * @abstract Requests another gateway for frames addressed to a lost instance.
+ * @discussion This request is issued when an instance is lost while frames
+ * that can be served by any gateway are still waiting for delivery.
+ * @param meshController The controller issuing the request.
+ * @param instance Instance that was lost.
+ * @return Instance to retransmit the frames to, or nil to drop them.
+ */
+- (id)meshController:(HYPMeshController *)meshController
+alternateInstanceForLostInstance:(id)instance;
+
 @end
@@ -0,0 +1,120 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @abstract Message store.
+ * @discussion This class keeps every chat message the device has seen,
+ * keyed by sid, in an append-only log on disk. Only the sids and the
+ * location of each record in the log are held in memory; messages are read
+ * back from the log when they are asked for. Sids are also kept in sorted
+ * order with their hashes and a fingerprint of every block of 1024 sorted
+ * positions. A range of sids is summarized for set reconciliation with
+ * other peers from the blocks it covers plus at most two partial blocks,
+ * and storing a sid, in any order, updates only the blocks after it.
+ * Messages are also numbered in the order they were stored, which is
+ * stable across launches since it is the order of the log. The log is
+ * scanned in the background on initialization, and calls made before the
+ * scan ends wait for it. The store is thread safe and can be shared by
+ * several bridges.
+ */
+@interface HYPMessageStore : NSObject
+
+/**
+ * @abstract Path of the log file.
+ */
+@property (atomic, readonly) NSString * path;
+
+/**
+ * @abstract Number of messages stored.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a store backed by the given file and starts
+ * scanning the messages it already holds. The file is created on the
+ * first write.
+ * @param path Path of the log file, or nil to keep the store in memory.
+ */
+- (instancetype)initWithPath:(NSString *)path;
+
+/**
+ * @abstract Default path of the log file.
+ * @discussion This path is inside the application support directory.
+ */
++ (NSString *)defaultPath;
+
+/**
+ * @abstract Adds a message.
+ * @discussion This method stores the message and appends it to the log,
+ * unless a message with the same sid is already stored.
+ * @param message Message with at least a sid.
+ * @return YES if the message was new.
+ */
+- (BOOL)addMessage:(NSDictionary *)message;
+
+/**
+ * @abstract Tells whether a message is stored.
+ */
+- (BOOL)containsMessageWithSid:(NSString *)sid;
+
+/**
+ * @abstract Stored messages with the given sids.
+ * @discussion Sids that are not stored are skipped.
+ */
+- (NSArray *)messagesWithSids:(NSArray *)sids;
+
+/**
+ * @abstract Stored messages in storage order.
+ * @param ordinal Ordinal of the first message; the first message stored is 0.
+ * @param count Maximum number of messages.
+ */
+- (NSArray *)messagesFromOrdinal:(NSUInteger)ordinal
+                           count:(NSUInteger)count;
+
+/**
+ * @abstract Sorted sids in a range.
+ * @param lowerSid Inclusive lower bound, or nil for no bound.
+ * @param upperSid Exclusive upper bound, or nil for no bound.
+ */
+- (NSArray *)sidsFromSid:(NSString *)lowerSid
+                   toSid:(NSString *)upperSid;
+
+/**
+ * @abstract Fingerprint of a range.
+ * @discussion The fingerprint is the exclusive or of the hashes of the sids
+ * in the range. Two stores holding the same sids in a range compute the
+ * same fingerprint and count for it.
+ * @param lowerSid Inclusive lower bound, or nil for no bound.
+ * @param upperSid Exclusive upper bound, or nil for no bound.
+ * @param count Set to the number of sids in the range.
+ */
+- (uint64_t)fingerprintFromSid:(NSString *)lowerSid
+                         toSid:(NSString *)upperSid
+                         count:(NSUInteger *)count;
+
+@end
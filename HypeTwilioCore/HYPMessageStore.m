@@ -0,0 +1,538 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPMessageStore.h"
+
+// Bytes of the log read at once while loading.
+static const NSUInteger HYPMessageStoreChunkLength = 1024 * 1024;
+
+// Sorted positions covered by each block fingerprint.
+static const NSUInteger HYPMessageStoreBlockLength = 1024;
+
+// Location of a record in the log, without its newline.
+typedef struct {
+    uint64_t offset;
+    uint64_t length;
+} HYPMessageStoreRecord;
+
+static uint64_t HYPMessageStoreHashSid(NSString * sid)
+{
+    // FNV-1a, so every platform hashes a sid the same way.
+    NSData * bytes = [sid dataUsingEncoding:NSUTF8StringEncoding];
+    const uint8_t * cursor = bytes.bytes;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    
+    for (NSUInteger i = 0; i < bytes.length; i++) {
+        hash ^= cursor[i];
+        hash *= 0x100000001b3ULL;
+    }
+    
+    return hash;
+}
+
+@interface HYPMessageStore ()
+
+@property (atomic, readwrite) NSString * path;
+@property (strong, atomic, readonly) NSMutableDictionary * ordinals;
+@property (strong, atomic, readonly) NSMutableData * records;
+@property (strong, atomic, readonly) NSMutableArray * lines;
+@property (strong, atomic, readonly) NSMutableArray * sortedSids;
+@property (strong, atomic, readonly) NSMutableData * sortedHashes;
+@property (strong, atomic, readonly) NSMutableData * blockFingerprints;
+@property (atomic, readonly) dispatch_group_t loadGroup;
+@property (atomic) NSFileHandle * fileHandle;
+@property (atomic) NSFileHandle * readHandle;
+
+@end
+
+@implementation HYPMessageStore
+@synthesize ordinals = _ordinals;
+@synthesize records = _records;
+@synthesize lines = _lines;
+@synthesize sortedSids = _sortedSids;
+@synthesize sortedHashes = _sortedHashes;
+@synthesize blockFingerprints = _blockFingerprints;
+@synthesize loadGroup = _loadGroup;
+
+- (instancetype)init
+{
+    return [self initWithPath:nil];
+}
+
+- (instancetype)initWithPath:(NSString *)path
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _path = path;
+        _ordinals = [NSMutableDictionary new];
+        _records = [NSMutableData new];
+        _lines = [NSMutableArray new];
+        _sortedSids = [NSMutableArray new];
+        _sortedHashes = [NSMutableData new];
+        _blockFingerprints = [NSMutableData new];
+        _loadGroup = dispatch_group_create();
+        
+        // Large logs take a while to scan, so the caller is not held up;
+        // the first call that needs the messages waits for the scan instead.
+        dispatch_group_async(_loadGroup, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [self load];
+        });
+    }
+    
+    return self;
+}
+
++ (NSString *)defaultPath
+{
+    NSString * directory = [NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, YES) firstObject];
+    
+    return [[directory stringByAppendingPathComponent:@"HypeTwilio"] stringByAppendingPathComponent:@"messages.log"];
+}
+
+- (void)waitUntilLoaded
+{
+    dispatch_group_wait(self.loadGroup, DISPATCH_TIME_FOREVER);
+}
+
+- (NSUInteger)count
+{
+    [self waitUntilLoaded];
+    
+    @synchronized(self) {
+        return self.ordinals.count;
+    }
+}
+
+#pragma mark - Log
+
+- (void)load
+{
+    if (self.path == nil) {
+        return;
+    }
+    
+    NSFileHandle * fileHandle = [NSFileHandle fileHandleForReadingAtPath:self.path];
+    
+    if (fileHandle == nil) {
+        return;
+    }
+    
+    @synchronized(self) {
+        
+        NSMutableData * pending = [NSMutableData new];
+        uint64_t pendingOffset = 0;
+        
+        // One JSON record per line. Only the sid of each record is kept;
+        // the rest is read back from the log when it is asked for.
+        while (YES) {
+            
+            @autoreleasepool {
+                
+                NSData * chunk = [fileHandle readDataOfLength:HYPMessageStoreChunkLength];
+                
+                if (chunk.length == 0) {
+                    break;
+                }
+                
+                [pending appendData:chunk];
+                
+                const uint8_t * bytes = pending.bytes;
+                NSUInteger start = 0;
+                
+                for (NSUInteger i = 0; i < pending.length; i++) {
+                    
+                    if (bytes[i] != '\n') {
+                        continue;
+                    }
+                    
+                    NSData * line = [pending subdataWithRange:NSMakeRange(start, i - start)];
+                    NSDictionary * message = [NSJSONSerialization JSONObjectWithData:line options:0 error:nil];
+                    
+                    if ([message isKindOfClass:[NSDictionary class]]) {
+                        
+                        HYPMessageStoreRecord record = { pendingOffset + start, i - start };
+                        [self appendSid:[message objectForKey:@"sid"] record:record];
+                    }
+                    
+                    start = i + 1;
+                }
+                
+                [pending replaceBytesInRange:NSMakeRange(0, start) withBytes:NULL length:0];
+                pendingOffset += start;
+            }
+        }
+        
+        [fileHandle closeFile];
+        [self sortSids];
+        
+        // A torn last line, left by a crash in the middle of a write, is cut
+        // off; otherwise the next record would be appended to the fragment.
+        if (pending.length > 0) {
+            
+            NSLog(@"Truncating %lu bytes of a torn record in %@", (unsigned long)pending.length, self.path);
+            
+            NSFileHandle * writeHandle = [NSFileHandle fileHandleForWritingAtPath:self.path];
+            [writeHandle truncateFileAtOffset:pendingOffset];
+            [writeHandle closeFile];
+        }
+    }
+}
+
+- (BOOL)appendLine:(NSData *)line record:(HYPMessageStoreRecord *)record
+{
+    if (self.path == nil) {
+        
+        // Without a log, the lines themselves are kept.
+        record->offset = self.lines.count;
+        record->length = line.length;
+        [self.lines addObject:line];
+        
+        return YES;
+    }
+    
+    if (self.fileHandle == nil) {
+        
+        NSFileManager * fileManager = [NSFileManager defaultManager];
+        
+        if (![fileManager fileExistsAtPath:self.path]) {
+            
+            [fileManager createDirectoryAtPath:[self.path stringByDeletingLastPathComponent]
+                   withIntermediateDirectories:YES
+                                    attributes:nil
+                                         error:nil];
+            [fileManager createFileAtPath:self.path contents:nil attributes:nil];
+        }
+        
+        self.fileHandle = [NSFileHandle fileHandleForWritingAtPath:self.path];
+    }
+    
+    if (self.fileHandle == nil) {
+        return NO;
+    }
+    
+    NSMutableData * data = [line mutableCopy];
+    [data appendBytes:"\n" length:1];
+    
+    record->offset = [self.fileHandle seekToEndOfFile];
+    record->length = line.length;
+    [self.fileHandle writeData:data];
+    
+    return YES;
+}
+
+- (NSData *)lineWithRecord:(HYPMessageStoreRecord)record
+{
+    if (self.path == nil) {
+        return [self.lines objectAtIndex:(NSUInteger)record.offset];
+    }
+    
+    if (self.readHandle == nil) {
+        self.readHandle = [NSFileHandle fileHandleForReadingAtPath:self.path];
+    }
+    
+    [self.readHandle seekToFileOffset:record.offset];
+    
+    return [self.readHandle readDataOfLength:(NSUInteger)record.length];
+}
+
+- (NSDictionary *)messageWithRecord:(HYPMessageStoreRecord)record
+{
+    NSData * line = [self lineWithRecord:record];
+    NSDictionary * message = line != nil ? [NSJSONSerialization JSONObjectWithData:line options:0 error:nil] : nil;
+    
+    return [message isKindOfClass:[NSDictionary class]] ? message : nil;
+}
+
+- (HYPMessageStoreRecord)recordWithOrdinal:(NSUInteger)ordinal
+{
+    return ((const HYPMessageStoreRecord *)self.records.bytes)[ordinal];
+}
+
+#pragma mark - Messages
+
+// Used while loading; the sids are sorted once the whole log is read.
+- (BOOL)appendSid:(NSString *)sid record:(HYPMessageStoreRecord)record
+{
+    if (![sid isKindOfClass:[NSString class]] || [self.ordinals objectForKey:sid] != nil) {
+        return NO;
+    }
+    
+    [self.ordinals setObject:@(self.ordinals.count) forKey:sid];
+    [self.records appendBytes:&record length:sizeof(record)];
+    [self.sortedSids addObject:sid];
+    
+    return YES;
+}
+
+- (BOOL)insertSid:(NSString *)sid record:(HYPMessageStoreRecord)record
+{
+    if (![sid isKindOfClass:[NSString class]] || [self.ordinals objectForKey:sid] != nil) {
+        return NO;
+    }
+    
+    NSUInteger index = [self indexOfSid:sid];
+    uint64_t hash = HYPMessageStoreHashSid(sid);
+    
+    [self.ordinals setObject:@(self.ordinals.count) forKey:sid];
+    [self.records appendBytes:&record length:sizeof(record)];
+    [self.sortedSids insertObject:sid atIndex:index];
+    [self.sortedHashes replaceBytesInRange:NSMakeRange(index * sizeof(hash), 0)
+                                 withBytes:&hash
+                                    length:sizeof(hash)];
+    
+    [self shiftBlockFingerprintsFromIndex:index];
+    
+    return YES;
+}
+
+- (BOOL)addMessage:(NSDictionary *)message
+{
+    NSMutableDictionary * record = [message mutableCopy];
+    NSString * sid = [record objectForKey:@"sid"];
+    
+    // Frame routing keys are not part of the message.
+    [record removeObjectForKey:@"type"];
+    [record removeObjectForKey:@"nonce"];
+    
+    [self waitUntilLoaded];
+    
+    @synchronized(self) {
+        
+        if (![sid isKindOfClass:[NSString class]] || [self.ordinals objectForKey:sid] != nil) {
+            return NO;
+        }
+        
+        NSData * line = [NSJSONSerialization dataWithJSONObject:record options:0 error:nil];
+        HYPMessageStoreRecord location;
+        
+        if (line == nil || ![self appendLine:line record:&location]) {
+            NSLog(@"Message %@ cannot be stored", sid);
+            return NO;
+        }
+        
+        return [self insertSid:sid record:location];
+    }
+}
+
+- (BOOL)containsMessageWithSid:(NSString *)sid
+{
+    [self waitUntilLoaded];
+    
+    @synchronized(self) {
+        return [self.ordinals objectForKey:sid] != nil;
+    }
+}
+
+- (NSArray *)messagesWithSids:(NSArray *)sids
+{
+    NSMutableArray * messages = [NSMutableArray new];
+    
+    [self waitUntilLoaded];
+    
+    @synchronized(self) {
+        
+        for (NSString * sid in sids) {
+            
+            NSNumber * ordinal = [self.ordinals objectForKey:sid];
+            NSDictionary * message = ordinal != nil ? [self messageWithRecord:[self recordWithOrdinal:ordinal.unsignedIntegerValue]] : nil;
+            
+            if (message != nil) {
+                [messages addObject:message];
+            }
+        }
+    }
+    
+    return messages;
+}
+
+- (NSArray *)messagesFromOrdinal:(NSUInteger)ordinal
+                           count:(NSUInteger)count
+{
+    [self waitUntilLoaded];
+    
+    @synchronized(self) {
+        
+        NSUInteger total = self.ordinals.count;
+        
+        if (ordinal >= total || count == 0) {
+            return @[];
+        }
+        
+        NSUInteger end = ordinal + MIN(count, total - ordinal);
+        NSMutableArray * messages = [NSMutableArray arrayWithCapacity:end - ordinal];
+        
+        if (self.path == nil) {
+            
+            for (NSUInteger i = ordinal; i < end; i++) {
+                [messages addObject:[self messageWithRecord:[self recordWithOrdinal:i]] ?: @{}];
+            }
+            
+            return messages;
+        }
+        
+        // Consecutive ordinals are consecutive lines of the log, so the
+        // whole span is read at once.
+        HYPMessageStoreRecord first = [self recordWithOrdinal:ordinal];
+        HYPMessageStoreRecord last = [self recordWithOrdinal:end - 1];
+        HYPMessageStoreRecord span = { first.offset, last.offset + last.length - first.offset };
+        NSData * lines = [self lineWithRecord:span];
+        
+        for (NSUInteger i = ordinal; i < end; i++) {
+            
+            HYPMessageStoreRecord record = [self recordWithOrdinal:i];
+            
+            if (record.offset + record.length - first.offset > lines.length) {
+                break;
+            }
+            
+            NSData * line = [lines subdataWithRange:NSMakeRange((NSUInteger)(record.offset - first.offset), (NSUInteger)record.length)];
+            NSDictionary * message = [NSJSONSerialization JSONObjectWithData:line options:0 error:nil];
+            
+            [messages addObject:[message isKindOfClass:[NSDictionary class]] ? message : @{}];
+        }
+        
+        return messages;
+    }
+}
+
+#pragma mark - Ranges
+
+- (NSUInteger)indexOfSid:(NSString *)sid
+{
+    return [self.sortedSids indexOfObject:sid
+                            inSortedRange:NSMakeRange(0, self.sortedSids.count)
+                                  options:NSBinarySearchingInsertionIndex | NSBinarySearchingFirstEqual
+                          usingComparator:^NSComparisonResult(NSString * a, NSString * b) {
+                              return [a compare:b options:NSLiteralSearch];
+                          }];
+}
+
+- (NSRange)rangeFromSid:(NSString *)lowerSid
+                  toSid:(NSString *)upperSid
+{
+    NSUInteger lower = lowerSid != nil ? [self indexOfSid:lowerSid] : 0;
+    NSUInteger upper = upperSid != nil ? [self indexOfSid:upperSid] : self.sortedSids.count;
+    
+    return NSMakeRange(lower, upper > lower ? upper - lower : 0);
+}
+
+- (NSArray *)sidsFromSid:(NSString *)lowerSid
+                   toSid:(NSString *)upperSid
+{
+    [self waitUntilLoaded];
+    
+    @synchronized(self) {
+        return [self.sortedSids subarrayWithRange:[self rangeFromSid:lowerSid toSid:upperSid]];
+    }
+}
+
+- (void)sortSids
+{
+    [self.sortedSids sortUsingComparator:^NSComparisonResult(NSString * a, NSString * b) {
+        return [a compare:b options:NSLiteralSearch];
+    }];
+    
+    NSUInteger count = self.sortedSids.count;
+    
+    [self.sortedHashes setLength:count * sizeof(uint64_t)];
+    [self.blockFingerprints setLength:0];
+    [self.blockFingerprints setLength:(count + HYPMessageStoreBlockLength - 1) / HYPMessageStoreBlockLength * sizeof(uint64_t)];
+    
+    uint64_t * hashes = self.sortedHashes.mutableBytes;
+    uint64_t * blocks = self.blockFingerprints.mutableBytes;
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        
+        hashes[i] = HYPMessageStoreHashSid(self.sortedSids[i]);
+        blocks[i / HYPMessageStoreBlockLength] ^= hashes[i];
+    }
+}
+
+// Block i holds the fingerprint of the sorted positions from i times the
+// block length on. A sid inserted at a position pushes the last sid of its
+// block and of every later block into the next one, so each of those
+// blocks gains one hash and loses another, without any rehashing.
+- (void)shiftBlockFingerprintsFromIndex:(NSUInteger)index
+{
+    NSUInteger count = self.sortedSids.count;
+    NSUInteger blockCount = (count + HYPMessageStoreBlockLength - 1) / HYPMessageStoreBlockLength;
+    
+    [self.blockFingerprints setLength:blockCount * sizeof(uint64_t)];
+    
+    const uint64_t * hashes = self.sortedHashes.bytes;
+    uint64_t * blocks = self.blockFingerprints.mutableBytes;
+    
+    for (NSUInteger block = index / HYPMessageStoreBlockLength; block < blockCount; block++) {
+        
+        NSUInteger first = block * HYPMessageStoreBlockLength;
+        NSUInteger next = first + HYPMessageStoreBlockLength;
+        
+        blocks[block] ^= hashes[MAX(index, first)];
+        
+        if (next < count) {
+            blocks[block] ^= hashes[next];
+        }
+    }
+}
+
+- (uint64_t)fingerprintFromSid:(NSString *)lowerSid
+                         toSid:(NSString *)upperSid
+                         count:(NSUInteger *)count
+{
+    [self waitUntilLoaded];
+    
+    @synchronized(self) {
+        
+        NSRange range = [self rangeFromSid:lowerSid toSid:upperSid];
+        const uint64_t * hashes = self.sortedHashes.bytes;
+        const uint64_t * blocks = self.blockFingerprints.bytes;
+        uint64_t fingerprint = 0;
+        NSUInteger end = NSMaxRange(range);
+        NSUInteger i = range.location;
+        
+        if (count != NULL) {
+            *count = range.length;
+        }
+        
+        // Whole blocks are taken from their fingerprints and the partial
+        // ones at both ends from the hashes.
+        while (i < end) {
+            
+            if (i % HYPMessageStoreBlockLength == 0 && i + HYPMessageStoreBlockLength <= end) {
+                fingerprint ^= blocks[i / HYPMessageStoreBlockLength];
+                i += HYPMessageStoreBlockLength;
+            } else {
+                fingerprint ^= hashes[i];
+                i += 1;
+            }
+        }
+        
+        return fingerprint;
+    }
+}
+
+@end
@@ -0,0 +1,74 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @abstract Frame priority classes.
+ * @discussion Lower values are served first. Control frames carry the
+ * announcement and client handshake, interactive frames carry text typed
+ * by a user, relay frames carry messages fanned out by a gateway and
+ * backfill frames carry history.
+ */
+typedef NS_ENUM(NSUInteger, HYPFramePriority) {
+    HYPFramePriorityControl = 0,
+    HYPFramePriorityInteractive,
+    HYPFramePriorityRelay,
+    HYPFramePriorityBackfill,
+    HYPFramePriorityCount
+};
+
+/**
+ * @abstract Outbound frame.
+ * @discussion This class holds a frame that was handed to the reliable
+ * sender, together with the bookkeeping needed to retransmit it until
+ * the destination confirms delivery.
+ */
+@interface HYPOutboundFrame : NSObject
+
+@property (atomic, readonly) NSData * data;
+@property (atomic) id peer;
+@property (atomic, readonly) BOOL retargetable;
+@property (atomic, readonly) HYPFramePriority priority;
+@property (atomic) NSDate * enqueueDate;
+@property (atomic) NSUInteger identifier;
+@property (atomic) NSUInteger attempts;
+@property (atomic) NSDate * sentDate;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a frame with the given payload and destination.
+ * @param data Payload to send.
+ * @param peer Destination peer.
+ * @param priority Priority class of the frame.
+ * @param retargetable Whether the frame may be sent to another gateway
+ * if the destination is lost.
+ */
+- (instancetype)initWithData:(NSData *)data
+                        peer:(id)peer
+                    priority:(HYPFramePriority)priority
+                retargetable:(BOOL)retargetable;
+
+@end
@@ -0,0 +1,61 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPOutboundFrame.h"
+
+@interface HYPOutboundFrame ()
+
+@property (atomic, readwrite) NSData * data;
+@property (atomic, readwrite) BOOL retargetable;
+@property (atomic, readwrite) HYPFramePriority priority;
+
+@end
+
+@implementation HYPOutboundFrame
+
+@synthesize data = _data;
+@synthesize retargetable = _retargetable;
+@synthesize priority = _priority;
+
+- (instancetype)initWithData:(NSData *)data
+                        peer:(id)peer
+                    priority:(HYPFramePriority)priority
+                retargetable:(BOOL)retargetable
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _data = data;
+        _peer = peer;
+        _priority = priority;
+        _retargetable = retargetable;
+        _enqueueDate = [NSDate date];
+    }
+    
+    return self;
+}
+
+@end
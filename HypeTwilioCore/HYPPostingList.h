@@ -0,0 +1,106 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @abstract Appends a variable length integer.
+ * @discussion Seven bits per byte, least significant first, with the high
+ * bit set on every byte but the last.
+ */
+FOUNDATION_EXPORT void HYPAppendVarint(NSMutableData * data, uint64_t value);
+
+/**
+ * @abstract Reads a variable length integer.
+ * @param offset Position to read at, advanced past the integer.
+ * @return NO if the bytes end before the integer does.
+ */
+FOUNDATION_EXPORT BOOL HYPReadVarint(const uint8_t * bytes, NSUInteger length, NSUInteger * offset, uint64_t * value);
+
+/**
+ * @abstract Posting list.
+ * @discussion This class holds the ascending document numbers a term occurs
+ * in, each encoded as a variable length delta from the previous one. Most
+ * deltas in a chat history fit in one or two bytes.
+ */
+@interface HYPPostingList : NSObject
+
+/**
+ * @abstract Encoded deltas.
+ */
+@property (atomic, readonly) NSData * data;
+
+/**
+ * @abstract Number of documents in the list.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ * @abstract Last document in the list.
+ */
+@property (atomic, readonly) NSUInteger lastDocument;
+
+/**
+ * @abstract Length of the encoded deltas, in bytes.
+ */
+@property (atomic, readonly) NSUInteger length;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a list from encoded deltas.
+ * @param data Encoded deltas.
+ * @return The list, or nil if the deltas are malformed.
+ */
+- (instancetype)initWithData:(NSData *)data;
+
+/**
+ * @abstract Appends a document.
+ * @discussion Documents must be appended in ascending order; appending the
+ * last document again does nothing.
+ * @param document Document number.
+ */
+- (void)appendDocument:(NSUInteger)document;
+
+/**
+ * @abstract Appends encoded deltas.
+ * @discussion Deltas are appended as they are, so the bytes a list grew by
+ * since some length can be appended to a copy of the list at that length.
+ * @param data Encoded deltas.
+ * @return NO, leaving the list as it was, if the deltas are malformed.
+ */
+- (BOOL)appendData:(NSData *)data;
+
+/**
+ * @abstract Encoded deltas past an offset.
+ * @param offset Offset in the encoded deltas.
+ */
+- (NSData *)dataFromOffset:(NSUInteger)offset;
+
+/**
+ * @abstract Adds the documents of the list to an index set.
+ */
+- (void)addDocumentsToIndexSet:(NSMutableIndexSet *)indexSet;
+
+@end
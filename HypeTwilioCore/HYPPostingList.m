@@ -0,0 +1,180 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPPostingList.h"
+
+void HYPAppendVarint(NSMutableData * data, uint64_t value)
+{
+    uint8_t bytes[10];
+    NSUInteger length = 0;
+    
+    while (value >= 0x80) {
+        bytes[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    
+    bytes[length++] = (uint8_t)value;
+    [data appendBytes:bytes length:length];
+}
+
+BOOL HYPReadVarint(const uint8_t * bytes, NSUInteger length, NSUInteger * offset, uint64_t * value)
+{
+    uint64_t result = 0;
+    
+    for (unsigned shift = 0; *offset < length && shift < 64; shift += 7) {
+        
+        uint8_t byte = bytes[(*offset)++];
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return YES;
+        }
+    }
+    
+    return NO;
+}
+
+@interface HYPPostingList ()
+
+@property (strong, atomic, readonly) NSMutableData * deltas;
+@property (atomic, readwrite) NSUInteger count;
+@property (atomic, readwrite) NSUInteger lastDocument;
+
+@end
+
+@implementation HYPPostingList
+@synthesize deltas = _deltas;
+
+- (instancetype)init
+{
+    return [self initWithData:[NSData data]];
+}
+
+- (instancetype)initWithData:(NSData *)data
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _deltas = [NSMutableData new];
+        
+        if (![self appendData:data]) {
+            return nil;
+        }
+    }
+    
+    return self;
+}
+
+- (NSUInteger)length
+{
+    @synchronized(self) {
+        return self.deltas.length;
+    }
+}
+
+- (BOOL)appendData:(NSData *)data
+{
+    @synchronized(self) {
+        
+        // Decoding once recovers the count and the base for new deltas.
+        const uint8_t * bytes = data.bytes;
+        NSUInteger offset = 0;
+        NSUInteger count = self.count;
+        uint64_t document = self.lastDocument;
+        
+        while (offset < data.length) {
+            
+            uint64_t delta;
+            
+            if (!HYPReadVarint(bytes, data.length, &offset, &delta)) {
+                return NO;
+            }
+            
+            document += delta;
+            count++;
+        }
+        
+        [self.deltas appendData:data];
+        self.count = count;
+        self.lastDocument = (NSUInteger)document;
+        
+        return YES;
+    }
+}
+
+- (NSData *)dataFromOffset:(NSUInteger)offset
+{
+    @synchronized(self) {
+        
+        NSUInteger length = self.deltas.length;
+        offset = MIN(offset, length);
+        
+        return [self.deltas subdataWithRange:NSMakeRange(offset, length - offset)];
+    }
+}
+
+- (NSData *)data
+{
+    @synchronized(self) {
+        return [self.deltas copy];
+    }
+}
+
+- (void)appendDocument:(NSUInteger)document
+{
+    @synchronized(self) {
+        
+        // The first document is stored as a delta from zero.
+        if (self.count > 0 && document <= self.lastDocument) {
+            return;
+        }
+        
+        HYPAppendVarint(self.deltas, document - (self.count > 0 ? self.lastDocument : 0));
+        
+        self.lastDocument = document;
+        self.count++;
+    }
+}
+
+- (void)addDocumentsToIndexSet:(NSMutableIndexSet *)indexSet
+{
+    @synchronized(self) {
+        
+        const uint8_t * bytes = self.deltas.bytes;
+        NSUInteger length = self.deltas.length;
+        NSUInteger offset = 0;
+        uint64_t document = 0;
+        uint64_t delta;
+        
+        while (HYPReadVarint(bytes, length, &offset, &delta)) {
+            document += delta;
+            [indexSet addIndex:(NSUInteger)document];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,140 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPReliableSenderDelegate.h"
+#import "HYPFrameScheduler.h"
+
+/**
+ * @abstract Reliable sender.
+ * @discussion This class keeps every outbound frame until the link
+ * confirms its delivery. Frames that fail or time out are retransmitted,
+ * frames addressed to a lost gateway are moved to another one, and the
+ * number of frames in flight to each peer is capped by a send window.
+ * Control frames are exempt from the windows, and part of each window is
+ * kept for interactive frames so that bulk traffic cannot starve them.
+ * Frames waiting for a window are ordered by the frame scheduler.
+ */
+@interface HYPReliableSender : NSObject
+
+@property (atomic, weak) id<HYPReliableSenderDelegate> delegate;
+
+/**
+ * @abstract Maximum number of unconfirmed frames per peer.
+ */
+@property (atomic) NSUInteger windowSize;
+
+/**
+ * @abstract Maximum number of unconfirmed frames across all peers.
+ */
+@property (atomic) NSUInteger totalWindowSize;
+
+/**
+ * @abstract Slots of both windows that relay and backfill frames cannot take.
+ */
+@property (atomic) NSUInteger reservedWindowSize;
+
+/**
+ * @abstract Maximum number of transmissions of a single frame.
+ */
+@property (atomic) NSUInteger maximumAttempts;
+
+/**
+ * @abstract Time after which an unconfirmed frame is retransmitted.
+ * @discussion Setting it restarts the retransmission timer, which fires
+ * at half this interval.
+ */
+@property (atomic) NSTimeInterval timeout;
+
+/**
+ * @abstract Scheduler holding the frames waiting for a send window.
+ */
+@property (atomic, readonly) HYPFrameScheduler * scheduler;
+
+@property (atomic, readonly) NSUInteger transmissions;
+@property (atomic, readonly) NSUInteger retransmissions;
+@property (atomic, readonly) NSUInteger deliveredFrames;
+@property (atomic, readonly) NSUInteger deliveredBytes;
+@property (atomic, readonly) NSUInteger droppedFrames;
+
+/**
+ * @abstract Delivered payload bytes per second since the sender was created.
+ */
+@property (atomic, readonly) double goodput;
+
+/**
+ * @abstract Fraction of transmissions that were retransmissions.
+ */
+@property (atomic, readonly) double retransmissionOverhead;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a sender whose retransmission timer fires on
+ * the given queue. This must be the queue on which the link issues its
+ * notifications, since retransmissions call back into the link.
+ * @param queue Serial queue of the link.
+ */
+- (instancetype)initWithQueue:(dispatch_queue_t)queue;
+
+/**
+ * @abstract Sends a frame.
+ * @discussion This method queues a frame to the given peer. The frame is
+ * transmitted as soon as the peer's send window allows it.
+ * @param data Frame payload.
+ * @param peer Destination peer.
+ * @param priority Priority class of the frame.
+ * @param retargetable Whether the frame may go to another gateway if the
+ * destination is lost.
+ */
+- (void)sendData:(NSData *)data
+          toPeer:(id)peer
+        priority:(HYPFramePriority)priority
+    retargetable:(BOOL)retargetable;
+
+/**
+ * @abstract Notifys the sender that a message was delivered.
+ * @discussion This method releases the frame and opens the send window.
+ * @param identifier Identifier the link assigned to the message.
+ */
+- (void)didDeliverMessageWithIdentifier:(NSUInteger)identifier;
+
+/**
+ * @abstract Notifys the sender that a message failed to be sent.
+ * @discussion This method leaves the frame in flight, to be retransmitted
+ * once the timeout passes, so a transient failure does not use up its
+ * attempts.
+ * @param identifier Identifier the link assigned to the message.
+ */
+- (void)didFailSendingMessageWithIdentifier:(NSUInteger)identifier;
+
+/**
+ * @abstract Notifys the sender that a peer was lost.
+ * @discussion This method moves retargetable frames addressed to the peer
+ * to an alternate peer and drops the remaining ones.
+ * @param peer Peer that was lost.
+ */
+- (void)didLosePeer:(id)peer;
+
+@end
@@ -0,0 +1,382 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPReliableSender.h"
+#import "HYPOutboundFrame.h"
+
+@interface HYPReliableSender ()
+
+@property (strong, atomic, readonly) NSMutableDictionary * inFlightFrames;
+@property (strong, atomic, readonly) NSMutableDictionary * inFlightCounts;
+@property (atomic) NSUInteger windowedFrames;
+@property (strong, atomic, readonly) NSDate * startDate;
+@property (atomic, readonly) dispatch_queue_t queue;
+@property (atomic) dispatch_source_t timer;
+@property (atomic, readwrite) NSUInteger transmissions;
+@property (atomic, readwrite) NSUInteger retransmissions;
+@property (atomic, readwrite) NSUInteger deliveredFrames;
+@property (atomic, readwrite) NSUInteger deliveredBytes;
+@property (atomic, readwrite) NSUInteger droppedFrames;
+
+@end
+
+@implementation HYPReliableSender
+@synthesize scheduler = _scheduler;
+@synthesize inFlightFrames = _inFlightFrames;
+@synthesize inFlightCounts = _inFlightCounts;
+@synthesize startDate = _startDate;
+@synthesize queue = _queue;
+
+- (instancetype)init
+{
+    return [self initWithQueue:dispatch_get_main_queue()];
+}
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _queue = queue;
+        _scheduler = [[HYPFrameScheduler alloc] init];
+        _inFlightFrames = [NSMutableDictionary new];
+        _inFlightCounts = [NSMutableDictionary new];
+        _startDate = [NSDate date];
+        _windowSize = 8;
+        _totalWindowSize = 32;
+        _reservedWindowSize = 2;
+        _maximumAttempts = 5;
+        _timeout = 15.0;
+        
+        [self startTimer];
+    }
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_timer != nil) {
+        dispatch_source_cancel(_timer);
+    }
+}
+
+- (NSTimeInterval)timeout
+{
+    @synchronized(self) {
+        return _timeout;
+    }
+}
+
+- (void)setTimeout:(NSTimeInterval)timeout
+{
+    @synchronized(self) {
+        
+        _timeout = timeout;
+        [self startTimer];
+    }
+}
+
+- (void)startTimer
+{
+    if (self.timer != nil) {
+        dispatch_source_cancel(self.timer);
+    }
+    
+    // Retransmissions call back into the link, which expects to be used
+    // from its own queue.
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.queue);
+    uint64_t interval = (uint64_t)(self.timeout * NSEC_PER_SEC / 2);
+    
+    __weak HYPReliableSender * weakSelf = self;
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, NSEC_PER_SEC / 10);
+    dispatch_source_set_event_handler(timer, ^{
+        [weakSelf retransmitExpiredFrames];
+    });
+    dispatch_resume(timer);
+    
+    self.timer = timer;
+}
+
+- (double)goodput
+{
+    NSTimeInterval elapsed = -[self.startDate timeIntervalSinceNow];
+    
+    return elapsed > 0 ? self.deliveredBytes / elapsed : 0;
+}
+
+- (double)retransmissionOverhead
+{
+    NSUInteger transmissions = self.transmissions;
+    
+    return transmissions > 0 ? (double)self.retransmissions / transmissions : 0;
+}
+
+#pragma mark - Sending
+
+- (void)sendData:(NSData *)data
+          toPeer:(id)peer
+        priority:(HYPFramePriority)priority
+    retargetable:(BOOL)retargetable
+{
+    if (data == nil || peer == nil) {
+        return;
+    }
+    
+    HYPOutboundFrame * frame = [[HYPOutboundFrame alloc] initWithData:data
+                                                                 peer:peer
+                                                             priority:priority
+                                                         retargetable:retargetable];
+    
+    @synchronized(self) {
+        
+        [self.scheduler enqueueFrame:frame forPeerIdentifier:[self identifierForPeer:peer]];
+        [self pump];
+    }
+}
+
+- (NSString *)identifierForPeer:(id)peer
+{
+    return [self.delegate reliableSender:self identifierForPeer:peer];
+}
+
+- (NSUInteger)inFlightCountForPeerIdentifier:(NSString *)peerIdentifier
+{
+    return [[self.inFlightCounts objectForKey:peerIdentifier] unsignedIntegerValue];
+}
+
+- (void)setInFlightCount:(NSUInteger)count forPeerIdentifier:(NSString *)peerIdentifier
+{
+    if (count == 0) {
+        [self.inFlightCounts removeObjectForKey:peerIdentifier];
+    } else {
+        [self.inFlightCounts setObject:@(count) forKey:peerIdentifier];
+    }
+}
+
+- (BOOL)isWindowedPriority:(HYPFramePriority)priority
+{
+    return priority != HYPFramePriorityControl;
+}
+
+- (BOOL)windowIsOpenForPeerIdentifier:(NSString *)peerIdentifier
+                             priority:(HYPFramePriority)priority
+{
+    if (![self isWindowedPriority:priority]) {
+        return YES;
+    }
+    
+    NSUInteger reserved = priority == HYPFramePriorityInteractive ? 0 : self.reservedWindowSize;
+    
+    return self.windowedFrames + reserved < self.totalWindowSize
+        && [self inFlightCountForPeerIdentifier:peerIdentifier] + reserved < self.windowSize;
+}
+
+- (void)pump
+{
+    __weak HYPReliableSender * weakSelf = self;
+    BOOL (^windowIsOpen)(NSString *, HYPFramePriority) = ^BOOL(NSString * peerIdentifier, HYPFramePriority priority) {
+        return [weakSelf windowIsOpenForPeerIdentifier:peerIdentifier priority:priority];
+    };
+    
+    while (YES) {
+        
+        HYPOutboundFrame * frame = [self.scheduler dequeueFrameForPeersPassingTest:windowIsOpen];
+        
+        if (frame == nil) {
+            break;
+        }
+        
+        [self transmitFrame:frame peerIdentifier:[self identifierForPeer:frame.peer]];
+    }
+}
+
+- (void)transmitFrame:(HYPOutboundFrame *)frame peerIdentifier:(NSString *)peerIdentifier
+{
+    frame.attempts += 1;
+    frame.sentDate = [NSDate date];
+    
+    self.transmissions += 1;
+    if (frame.attempts > 1) {
+        self.retransmissions += 1;
+    }
+    
+    frame.identifier = [self.delegate reliableSender:self
+                                        transmitData:frame.data
+                                              toPeer:frame.peer];
+    
+    [self.inFlightFrames setObject:frame forKey:@(frame.identifier)];
+    
+    if ([self isWindowedPriority:frame.priority]) {
+        
+        self.windowedFrames += 1;
+        [self setInFlightCount:[self inFlightCountForPeerIdentifier:peerIdentifier] + 1
+             forPeerIdentifier:peerIdentifier];
+    }
+}
+
+- (HYPOutboundFrame *)removeInFlightFrameWithIdentifier:(NSUInteger)identifier
+{
+    HYPOutboundFrame * frame = [self.inFlightFrames objectForKey:@(identifier)];
+    
+    if (frame != nil) {
+        
+        NSString * peerIdentifier = [self identifierForPeer:frame.peer];
+        [self.inFlightFrames removeObjectForKey:@(identifier)];
+        
+        if ([self isWindowedPriority:frame.priority]) {
+            
+            self.windowedFrames -= 1;
+            [self setInFlightCount:[self inFlightCountForPeerIdentifier:peerIdentifier] - 1
+                 forPeerIdentifier:peerIdentifier];
+        }
+    }
+    
+    return frame;
+}
+
+- (void)retryFrame:(HYPOutboundFrame *)frame
+{
+    if (frame.attempts >= self.maximumAttempts) {
+        [self dropFrame:frame];
+        return;
+    }
+    
+    // Retransmissions go ahead of frames of the same class that were never
+    // sent so that the destination sees them in the order they were handed over.
+    [self.scheduler requeueFrame:frame forPeerIdentifier:[self identifierForPeer:frame.peer]];
+    [self pump];
+}
+
+- (void)dropFrame:(HYPOutboundFrame *)frame
+{
+    NSLog(@"Dropping frame after %lu attempts", (unsigned long)frame.attempts);
+    self.droppedFrames += 1;
+    
+    if ([self.delegate respondsToSelector:@selector(reliableSender:didDropData:toPeer:)]) {
+        [self.delegate reliableSender:self didDropData:frame.data toPeer:frame.peer];
+    }
+}
+
+#pragma mark - Link notifications
+
+- (void)didDeliverMessageWithIdentifier:(NSUInteger)identifier
+{
+    @synchronized(self) {
+        
+        HYPOutboundFrame * frame = [self removeInFlightFrameWithIdentifier:identifier];
+        
+        if (frame == nil) {
+            return;
+        }
+        
+        self.deliveredFrames += 1;
+        self.deliveredBytes += frame.data.length;
+        [self pump];
+    }
+}
+
+- (void)didFailSendingMessageWithIdentifier:(NSUInteger)identifier
+{
+    @synchronized(self) {
+        
+        HYPOutboundFrame * frame = [self.inFlightFrames objectForKey:@(identifier)];
+        
+        // Failures are often transient, like a full socket buffer or a link
+        // that comes back a moment later, so retrying at once would spend
+        // every attempt within milliseconds. The frame keeps its window slot
+        // and the retransmission timer retries it once it expires.
+        frame.sentDate = [NSDate date];
+    }
+    }
+}
+
+- (void)didLosePeer:(id)peer
+{
+    @synchronized(self) {
+        
+        NSString * peerIdentifier = [self identifierForPeer:peer];
+        NSMutableArray * frames = [NSMutableArray new];
+        
+        for (NSNumber * identifier in [self.inFlightFrames allKeys]) {
+            
+            HYPOutboundFrame * frame = [self.inFlightFrames objectForKey:identifier];
+            
+            if ([[self identifierForPeer:frame.peer] isEqualToString:peerIdentifier]) {
+                [self removeInFlightFrameWithIdentifier:frame.identifier];
+                [frames addObject:frame];
+            }
+        }
+        
+        [frames addObjectsFromArray:[self.scheduler removeFramesForPeerIdentifier:peerIdentifier]];
+        
+        id alternatePeer = nil;
+        
+        if ([self.delegate respondsToSelector:@selector(reliableSender:alternatePeerForLostPeer:)]) {
+            alternatePeer = [self.delegate reliableSender:self alternatePeerForLostPeer:peer];
+        }
+        
+        for (HYPOutboundFrame * frame in frames) {
+            
+            if (frame.retargetable && alternatePeer != nil) {
+                
+                frame.peer = alternatePeer;
+                [self.scheduler enqueueFrame:frame forPeerIdentifier:[self identifierForPeer:alternatePeer]];
+                
+            } else {
+                
+                [self dropFrame:frame];
+            }
+        }
+        
+        // Losing the peer also released its share of the total window.
+        [self pump];
+    }
+}
+
+- (void)retransmitExpiredFrames
+{
+    @synchronized(self) {
+        
+        NSDate * deadline = [NSDate dateWithTimeIntervalSinceNow:-self.timeout];
+        NSMutableArray * expiredFrames = [NSMutableArray new];
+        
+        for (HYPOutboundFrame * frame in [self.inFlightFrames allValues]) {
+            
+            if ([frame.sentDate compare:deadline] == NSOrderedAscending) {
+                [expiredFrames addObject:frame];
+            }
+        }
+        
+        for (HYPOutboundFrame * frame in expiredFrames) {
+            
+            [self removeInFlightFrameWithIdentifier:frame.identifier];
+            [self retryFrame:frame];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,83 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @abstract Reliable sender delegate.
+ * @discussion This delegate hands frames over to the underlying link
+ * and is consulted when a frame needs a new destination or is given up on.
+ */
+@class HYPReliableSender;
+
+@protocol HYPReliableSenderDelegate <NSObject>
+
+/**
+ * @abstract Requests a frame to be written to the link.
+ * @discussion This method is called every time a frame is transmitted,
+ * including retransmissions.
+ * @param reliableSender The sender issuing the request.
+ * @param data Frame payload.
+ * @param peer Destination peer.
+ * @return Identifier the link assigned to the message.
+ */
+- (NSUInteger)reliableSender:(HYPReliableSender *)reliableSender
+                transmitData:(NSData *)data
+                      toPeer:(id)peer;
+
+/**
+ * @abstract Requests a stable identifier for a peer.
+ * @discussion The identifier is used to account in-flight frames per peer.
+ * @param reliableSender The sender issuing the request.
+ * @param peer Peer to identify.
+ */
+- (NSString *)reliableSender:(HYPReliableSender *)reliableSender
+           identifierForPeer:(id)peer;
+
+@optional
+
+/**
+ * @abstract Requests another destination for a frame.
+ * @discussion This method is called for retargetable frames whose
+ * destination was lost. Returning nil drops the frame.
+ * @param reliableSender The sender issuing the request.
+ * @param peer Peer that was lost.
+ */
+- (id)reliableSender:(HYPReliableSender *)reliableSender
+alternatePeerForLostPeer:(id)peer;
+
+/**
+ * @abstract Notification issued when a frame is given up on.
+ * @discussion This notification indicates that the frame exhausted its
+ * attempts or that its destination was lost with no alternative.
+ * @param reliableSender The sender issuing the notification.
+ * @param data Frame payload.
+ * @param peer Last destination of the frame.
+ */
+- (void)reliableSender:(HYPReliableSender *)reliableSender
+           didDropData:(NSData *)data
+                toPeer:(id)peer;
+
+@end
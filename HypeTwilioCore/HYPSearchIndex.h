@@ -0,0 +1,114 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPMessageStore.h"
+
+/**
+ * @abstract Search index.
+ * @discussion This class keeps an inverted index over the bodies and authors
+ * of the messages in a store. Each term maps to a posting list of message
+ * ordinals, and terms are kept sorted so a query word matches every term it
+ * is a prefix of. The index follows the store incrementally and writes a
+ * checkpoint next to it, so reopening only indexes the messages stored
+ * since. Saves append the postings changed since the previous one to a
+ * segment file beside the checkpoint, and rewrite the checkpoint only once
+ * the segment outgrows it. Indexing and queries run on a private serial
+ * queue.
+ */
+@interface HYPSearchIndex : NSObject
+
+@property (atomic, readonly) HYPMessageStore * messageStore;
+
+/**
+ * @abstract Path of the checkpoint file.
+ */
+@property (atomic, readonly) NSString * path;
+
+/**
+ * @abstract Number of messages indexed.
+ */
+@property (atomic, readonly) NSUInteger documentCount;
+
+/**
+ * @abstract Number of messages indexed between checkpoints. Defaults to 1024.
+ */
+@property (atomic) NSUInteger checkpointInterval;
+
+/**
+ * @abstract Time the last query took, in seconds.
+ */
+@property (atomic, readonly) NSTimeInterval lastQueryInterval;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes an index over the given store and starts loading
+ * its checkpoint in the background.
+ * @param messageStore Store to index.
+ * @param path Path of the checkpoint file, or nil not to persist the index.
+ */
+- (instancetype)initWithMessageStore:(HYPMessageStore *)messageStore
+                                path:(NSString *)path;
+
+/**
+ * @abstract Indexes new messages.
+ * @discussion This method indexes, in the background, the messages added
+ * to the store since the last update. Calls made while an update is
+ * pending are merged into it.
+ */
+- (void)update;
+
+/**
+ * @abstract Writes a checkpoint.
+ * @discussion This method saves the index in the background.
+ */
+- (void)save;
+
+/**
+ * @abstract Writes a checkpoint.
+ * @discussion This method saves the index in the background, like save.
+ * @param completion Called on the main queue once the index is saved, or
+ * nil.
+ */
+- (void)saveWithCompletion:(void (^)(void))completion;
+
+/**
+ * @abstract Searches the messages.
+ * @discussion Every word of the query must prefix a word of the message
+ * body or author; case and diacritics are ignored. Messages stored since
+ * the last update are indexed first. Matches are ranked by the order they
+ * were stored in, not by timestamp: backfill stores history from the newest
+ * page down, so old messages it copied rank above the live messages stored
+ * before them.
+ * @param query Query text.
+ * @param limit Maximum number of messages.
+ * @param completion Called on the main queue with the matching messages,
+ * most recently stored first.
+ */
+- (void)searchWithQuery:(NSString *)query
+                  limit:(NSUInteger)limit
+             completion:(void (^)(NSArray * messages))completion;
+
+@end
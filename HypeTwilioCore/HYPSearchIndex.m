@@ -0,0 +1,589 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPSearchIndex.h"
+#import "HYPPostingList.h"
+
+// Header of checkpoint files: a magic number and a format version.
+static const uint8_t HYPSearchIndexMagic[] = { 'H', 'Y', 'P', 'I', 1 };
+
+// Header of segment files, which hold the deltas saved since the checkpoint.
+static const uint8_t HYPSearchSegmentMagic[] = { 'H', 'Y', 'P', 'S', 1 };
+
+// Number of messages read from the store at once while indexing.
+static const NSUInteger HYPSearchIndexPageSize = 1024;
+
+@interface HYPSearchIndex ()
+
+@property (atomic, readwrite) HYPMessageStore * messageStore;
+@property (atomic, readwrite) NSString * path;
+@property (atomic, readwrite) NSUInteger documentCount;
+@property (atomic, readwrite) NSTimeInterval lastQueryInterval;
+@property (atomic, readonly) dispatch_queue_t queue;
+@property (strong, atomic, readonly) NSMutableDictionary * postings;
+@property (strong, atomic, readonly) NSMutableDictionary * dirtyLengths;
+@property (atomic, readonly) NSString * segmentPath;
+@property (atomic) NSUInteger checkpointLength;
+@property (atomic) NSUInteger segmentLength;
+@property (atomic) NSArray * sortedTerms;
+@property (atomic) NSUInteger savedDocumentCount;
+@property (atomic) BOOL updatePending;
+
+@end
+
+@implementation HYPSearchIndex
+@synthesize queue = _queue;
+@synthesize postings = _postings;
+@synthesize dirtyLengths = _dirtyLengths;
+
+- (instancetype)initWithMessageStore:(HYPMessageStore *)messageStore
+                                path:(NSString *)path
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _messageStore = messageStore;
+        _path = path;
+        _queue = dispatch_queue_create("com.hypelabs.search", DISPATCH_QUEUE_SERIAL);
+        _postings = [NSMutableDictionary new];
+        _dirtyLengths = [NSMutableDictionary new];
+        _checkpointInterval = 1024;
+        
+        dispatch_async(_queue, ^{
+            [self load];
+        });
+        
+        [self update];
+    }
+    
+    return self;
+}
+
+#pragma mark - Terms
+
++ (NSArray *)termsInString:(NSString *)string
+{
+    static NSCharacterSet * separators;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        separators = [[NSCharacterSet alphanumericCharacterSet] invertedSet];
+    });
+    
+    if (![string isKindOfClass:[NSString class]]) {
+        return @[];
+    }
+    
+    NSString * folded = [string stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch
+                                                    locale:nil];
+    NSMutableArray * terms = [NSMutableArray new];
+    
+    for (NSString * term in [folded componentsSeparatedByCharactersInSet:separators]) {
+        
+        if (term.length > 0) {
+            [terms addObject:term];
+        }
+    }
+    
+    return terms;
+}
+
+- (NSArray *)termsWithPrefix:(NSString *)prefix
+{
+    if (self.sortedTerms == nil) {
+        self.sortedTerms = [self.postings.allKeys sortedArrayUsingComparator:^NSComparisonResult(NSString * a, NSString * b) {
+            return [a compare:b options:NSLiteralSearch];
+        }];
+    }
+    
+    NSArray * sortedTerms = self.sortedTerms;
+    NSUInteger index = [sortedTerms indexOfObject:prefix
+                                    inSortedRange:NSMakeRange(0, sortedTerms.count)
+                                          options:NSBinarySearchingInsertionIndex | NSBinarySearchingFirstEqual
+                                  usingComparator:^NSComparisonResult(NSString * a, NSString * b) {
+                                      return [a compare:b options:NSLiteralSearch];
+                                  }];
+    NSMutableArray * terms = [NSMutableArray new];
+    
+    // Terms sharing a prefix are contiguous in literal order.
+    for (; index < sortedTerms.count && [sortedTerms[index] hasPrefix:prefix]; index++) {
+        [terms addObject:sortedTerms[index]];
+    }
+    
+    return terms;
+}
+
+#pragma mark - Indexing
+
+- (void)update
+{
+    @synchronized(self) {
+        
+        if (self.updatePending) {
+            return;
+        }
+        
+        self.updatePending = YES;
+    }
+    
+    dispatch_async(self.queue, ^{
+        
+        @synchronized(self) {
+            self.updatePending = NO;
+        }
+        
+        [self indexNewMessages];
+        
+        if (self.documentCount >= self.savedDocumentCount + self.checkpointInterval) {
+            [self writeCheckpoint];
+        }
+    });
+}
+
+- (void)indexNewMessages
+{
+    while (YES) {
+        
+        @autoreleasepool {
+            
+            NSArray * messages = [self.messageStore messagesFromOrdinal:self.documentCount
+                                                                  count:HYPSearchIndexPageSize];
+            
+            if (messages.count == 0) {
+                return;
+            }
+            
+            for (NSDictionary * message in messages) {
+                [self indexMessage:message document:self.documentCount];
+                self.documentCount++;
+            }
+        }
+    }
+}
+
+- (void)indexMessage:(NSDictionary *)message
+            document:(NSUInteger)document
+{
+    NSArray * terms = [[HYPSearchIndex termsInString:[message objectForKey:@"body"]]
+                       arrayByAddingObjectsFromArray:[HYPSearchIndex termsInString:[message objectForKey:@"author"]]];
+    
+    for (NSString * term in terms) {
+        
+        HYPPostingList * postingList = [self.postings objectForKey:term];
+        
+        if (postingList == nil) {
+            
+            postingList = [[HYPPostingList alloc] init];
+            [self.postings setObject:postingList forKey:term];
+            self.sortedTerms = nil;
+        }
+        
+        // The length at the last save tells which bytes the next one appends.
+        if ([self.dirtyLengths objectForKey:term] == nil) {
+            [self.dirtyLengths setObject:@(postingList.length) forKey:term];
+        }
+        
+        // Repeated terms of a message are skipped by the list.
+        [postingList appendDocument:document];
+    }
+}
+
+#pragma mark - Queries
+
+- (void)searchWithQuery:(NSString *)query
+                  limit:(NSUInteger)limit
+             completion:(void (^)(NSArray * messages))completion
+{
+    dispatch_async(self.queue, ^{
+        
+        NSDate * date = [NSDate date];
+        
+        [self indexNewMessages];
+        
+        NSMutableIndexSet * matches = nil;
+        
+        for (NSString * prefix in [HYPSearchIndex termsInString:query]) {
+            
+            NSMutableIndexSet * documents = [NSMutableIndexSet new];
+            
+            for (NSString * term in [self termsWithPrefix:prefix]) {
+                [[self.postings objectForKey:term] addDocumentsToIndexSet:documents];
+            }
+            
+            if (matches == nil) {
+                matches = documents;
+            } else {
+                [matches removeIndexes:[matches indexesPassingTest:^BOOL(NSUInteger document, BOOL * stop) {
+                    return ![documents containsIndex:document];
+                }]];
+            }
+            
+            if (matches.count == 0) {
+                break;
+            }
+        }
+        
+        NSMutableArray * messages = [NSMutableArray new];
+        
+        [matches enumerateIndexesWithOptions:NSEnumerationReverse usingBlock:^(NSUInteger document, BOOL * stop) {
+            
+            [messages addObjectsFromArray:[self.messageStore messagesFromOrdinal:document count:1]];
+            *stop = messages.count >= limit;
+        }];
+        
+        self.lastQueryInterval = -[date timeIntervalSinceNow];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(messages);
+        });
+    });
+}
+
+#pragma mark - Checkpoints
+
+- (NSString *)segmentPath
+{
+    return self.path != nil ? [self.path stringByAppendingPathExtension:@"segment"] : nil;
+}
+
+- (void)save
+{
+    [self saveWithCompletion:nil];
+}
+
+- (void)saveWithCompletion:(void (^)(void))completion
+{
+    dispatch_async(self.queue, ^{
+        
+        [self writeCheckpoint];
+        
+        if (completion != nil) {
+            dispatch_async(dispatch_get_main_queue(), completion);
+        }
+    });
+}
+
+// Saves append the postings changed since the last save to the segment,
+// so their cost follows what was indexed rather than the size of the
+// index. Once the segment outgrows the checkpoint the two are compacted.
+- (void)writeCheckpoint
+{
+    if (self.path == nil || self.documentCount == self.savedDocumentCount) {
+        return;
+    }
+    
+    NSData * record = [self segmentRecord];
+    
+    if (self.checkpointLength == 0 || self.segmentLength == 0 || self.segmentLength + record.length > self.checkpointLength) {
+        [self writeFullCheckpoint];
+    } else {
+        [self appendSegmentRecord:record];
+    }
+}
+
+- (void)writeFullCheckpoint
+{
+    NSMutableData * data = [NSMutableData dataWithBytes:HYPSearchIndexMagic length:sizeof(HYPSearchIndexMagic)];
+    NSUInteger postingLength = 0;
+    
+    HYPAppendVarint(data, self.documentCount);
+    HYPAppendVarint(data, self.postings.count);
+    
+    for (NSString * term in self.postings) {
+        
+        NSData * termData = [term dataUsingEncoding:NSUTF8StringEncoding];
+        NSData * postingData = [[self.postings objectForKey:term] data];
+        
+        HYPAppendVarint(data, termData.length);
+        [data appendData:termData];
+        HYPAppendVarint(data, postingData.length);
+        [data appendData:postingData];
+        
+        postingLength += postingData.length;
+    }
+    
+    [[NSFileManager defaultManager] createDirectoryAtPath:[self.path stringByDeletingLastPathComponent]
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:nil];
+    
+    if (![data writeToFile:self.path atomically:YES]) {
+        NSLog(@"Search index checkpoint not written");
+        return;
+    }
+    
+    // Records left in the segment if this fails start below the checkpoint
+    // and are skipped when loading.
+    NSData * segment = [NSData dataWithBytes:HYPSearchSegmentMagic length:sizeof(HYPSearchSegmentMagic)];
+    [segment writeToFile:self.segmentPath atomically:YES];
+    
+    self.checkpointLength = data.length;
+    self.segmentLength = segment.length;
+    self.savedDocumentCount = self.documentCount;
+    [self.dirtyLengths removeAllObjects];
+    
+    NSLog(@"Indexed %lu messages [%lu terms, %.1f posting bytes per message, %lu bytes on disk]",
+          (unsigned long)self.documentCount,
+          (unsigned long)self.postings.count,
+          (double)postingLength / MAX(self.documentCount, 1),
+          (unsigned long)data.length);
+}
+
+// A record is the length of its body, followed by the document counts it
+// goes from and to and the bytes each changed posting list grew by.
+- (NSData *)segmentRecord
+{
+    NSMutableData * body = [NSMutableData new];
+    
+    HYPAppendVarint(body, self.savedDocumentCount);
+    HYPAppendVarint(body, self.documentCount);
+    HYPAppendVarint(body, self.dirtyLengths.count);
+    
+    for (NSString * term in self.dirtyLengths) {
+        
+        NSData * termData = [term dataUsingEncoding:NSUTF8StringEncoding];
+        NSData * postingData = [[self.postings objectForKey:term] dataFromOffset:[[self.dirtyLengths objectForKey:term] unsignedIntegerValue]];
+        
+        HYPAppendVarint(body, termData.length);
+        [body appendData:termData];
+        HYPAppendVarint(body, postingData.length);
+        [body appendData:postingData];
+    }
+    
+    NSMutableData * record = [NSMutableData new];
+    
+    HYPAppendVarint(record, body.length);
+    [record appendData:body];
+    
+    return record;
+}
+
+- (void)appendSegmentRecord:(NSData *)record
+{
+    NSFileHandle * fileHandle = [NSFileHandle fileHandleForWritingAtPath:self.segmentPath];
+    
+    if (fileHandle == nil) {
+        [self writeFullCheckpoint];
+        return;
+    }
+    
+    // Bytes past the known length are a torn record and are overwritten.
+    [fileHandle truncateFileAtOffset:self.segmentLength];
+    [fileHandle writeData:record];
+    [fileHandle closeFile];
+    
+    self.segmentLength += record.length;
+    self.savedDocumentCount = self.documentCount;
+    [self.dirtyLengths removeAllObjects];
+    
+    NSLog(@"Indexed %lu messages [%lu terms, %lu bytes on disk]",
+          (unsigned long)self.documentCount,
+          (unsigned long)self.postings.count,
+          (unsigned long)(self.checkpointLength + self.segmentLength));
+}
+
+- (void)load
+{
+    if (self.path == nil) {
+        return;
+    }
+    
+    NSData * data = [NSData dataWithContentsOfFile:self.path];
+    
+    if (data == nil) {
+        return;
+    }
+    
+    if (![self readCheckpoint:data]) {
+        
+        // Starting over rebuilds the index from the store.
+        NSLog(@"Search index checkpoint discarded");
+        [self.postings removeAllObjects];
+        self.documentCount = 0;
+        self.savedDocumentCount = 0;
+        self.sortedTerms = nil;
+        return;
+    }
+    
+    self.checkpointLength = data.length;
+    [self readSegment];
+    
+    self.sortedTerms = nil;
+}
+
+- (BOOL)readCheckpoint:(NSData *)data
+{
+    const uint8_t * bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger offset = sizeof(HYPSearchIndexMagic);
+    uint64_t documentCount;
+    uint64_t termCount;
+    
+    if (length < offset || memcmp(bytes, HYPSearchIndexMagic, offset) != 0) {
+        return NO;
+    }
+    
+    if (!HYPReadVarint(bytes, length, &offset, &documentCount) || !HYPReadVarint(bytes, length, &offset, &termCount)) {
+        return NO;
+    }
+    
+    // A checkpoint ahead of the store belongs to a store that was removed.
+    if (documentCount > self.messageStore.count) {
+        return NO;
+    }
+    
+    NSDictionary * postings = [self readPostingsWithCount:termCount bytes:bytes length:length offset:&offset];
+    
+    if (postings == nil) {
+        return NO;
+    }
+    
+    [self.postings setDictionary:postings];
+    
+    self.documentCount = (NSUInteger)documentCount;
+    self.savedDocumentCount = (NSUInteger)documentCount;
+    
+    return YES;
+}
+
+// Replays the records that continue the checkpoint. Reading stops at the
+// first record that is torn or does not follow, and the segment is cut
+// there so later records are appended after the last good one.
+- (void)readSegment
+{
+    NSData * data = [NSData dataWithContentsOfFile:self.segmentPath];
+    const uint8_t * bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger offset = sizeof(HYPSearchSegmentMagic);
+    
+    if (length < offset || memcmp(bytes, HYPSearchSegmentMagic, offset) != 0) {
+        return;
+    }
+    
+    while (offset < length) {
+        
+        NSUInteger recordOffset = offset;
+        uint64_t recordLength;
+        uint64_t fromCount;
+        uint64_t toCount;
+        uint64_t termCount;
+        
+        if (!HYPReadVarint(bytes, length, &offset, &recordLength) || recordLength > length - offset) {
+            offset = recordOffset;
+            break;
+        }
+        
+        NSUInteger end = offset + (NSUInteger)recordLength;
+        
+        if (!HYPReadVarint(bytes, end, &offset, &fromCount) ||
+            !HYPReadVarint(bytes, end, &offset, &toCount) ||
+            !HYPReadVarint(bytes, end, &offset, &termCount)) {
+            offset = recordOffset;
+            break;
+        }
+        
+        // Records written before the last compaction are already in the checkpoint.
+        if (toCount <= self.documentCount) {
+            offset = end;
+            continue;
+        }
+        
+        if (fromCount != self.documentCount || toCount > self.messageStore.count) {
+            offset = recordOffset;
+            break;
+        }
+        
+        NSDictionary * postings = [self readPostingsWithCount:termCount bytes:bytes length:end offset:&offset];
+        
+        if (postings == nil) {
+            offset = recordOffset;
+            break;
+        }
+        
+        [self appendPostings:postings];
+        
+        self.documentCount = (NSUInteger)toCount;
+        self.savedDocumentCount = (NSUInteger)toCount;
+        offset = end;
+    }
+    
+    self.segmentLength = offset;
+}
+
+// Returns terms mapped to posting lists, or nil if the bytes are malformed.
+- (NSDictionary *)readPostingsWithCount:(uint64_t)termCount
+                                  bytes:(const uint8_t *)bytes
+                                 length:(NSUInteger)length
+                                 offset:(NSUInteger *)offset
+{
+    NSMutableDictionary * postings = [NSMutableDictionary new];
+    
+    for (uint64_t i = 0; i < termCount; i++) {
+        
+        uint64_t termLength;
+        uint64_t postingLength;
+        
+        if (!HYPReadVarint(bytes, length, offset, &termLength) || termLength > length - *offset) {
+            return nil;
+        }
+        
+        NSString * term = [[NSString alloc] initWithBytes:bytes + *offset
+                                                   length:(NSUInteger)termLength
+                                                 encoding:NSUTF8StringEncoding];
+        *offset += termLength;
+        
+        if (!HYPReadVarint(bytes, length, offset, &postingLength) || postingLength > length - *offset) {
+            return nil;
+        }
+        
+        HYPPostingList * postingList = [[HYPPostingList alloc] initWithData:[NSData dataWithBytes:bytes + *offset length:(NSUInteger)postingLength]];
+        *offset += postingLength;
+        
+        if (term == nil || postingList == nil) {
+            return nil;
+        }
+        
+        [postings setObject:postingList forKey:term];
+    }
+    
+    return postings;
+}
+
+- (void)appendPostings:(NSDictionary *)postings
+{
+    for (NSString * term in postings) {
+        
+        HYPPostingList * postingList = [self.postings objectForKey:term];
+        
+        if (postingList == nil) {
+            [self.postings setObject:[postings objectForKey:term] forKey:term];
+        } else {
+            [postingList appendData:[[postings objectForKey:term] data]];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,71 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPTransportDelegate.h"
+
+/**
+ * @abstract Transport.
+ * @discussion This protocol abstracts the link the bridge uses to reach
+ * offline peers. The app implements it on top of the Hype framework and the
+ * gateway daemon on top of UDP. Peers are opaque objects owned by the
+ * transport. Every notification must be issued on the transport's queue.
+ */
+@protocol HYPTransport <NSObject>
+
+@property (atomic, weak) id<HYPTransportDelegate> delegate;
+
+/**
+ * @abstract Serial queue on which notifications are issued.
+ * @discussion Work that calls back into the transport, such as
+ * retransmission timers, is scheduled on this queue.
+ */
+@property (atomic, readonly) dispatch_queue_t queue;
+
+/**
+ * @abstract Requests the transport to start.
+ * @discussion This method starts publishing the device and browsing for peers.
+ */
+- (void)start;
+
+/**
+ * @abstract Sends data to a peer.
+ * @discussion This method queues the data for output. The transport later
+ * issues a delivery or failure notification with the returned identifier.
+ * @param data Data to send.
+ * @param peer Destination peer.
+ * @return Identifier of the message.
+ */
+- (NSUInteger)sendData:(NSData *)data
+                toPeer:(id)peer;
+
+/**
+ * @abstract Getter.
+ * @discussion Gets a string that identifies the peer for as long as it is reachable.
+ * @param peer Peer to identify.
+ */
+- (NSString *)identifierForPeer:(id)peer;
+
+@end
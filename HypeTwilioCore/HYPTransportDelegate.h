@@ -0,0 +1,86 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @abstract Transport delegate.
+ * @discussion This delegate has the purpose of dealing with transport
+ * notifications. It is notified when peers become reachable or are lost,
+ * when data arrives and when sent messages are delivered or fail.
+ */
+@protocol HYPTransport;
+
+@protocol HYPTransportDelegate <NSObject>
+
+/**
+ * @abstract Notification issued when a peer becomes reachable.
+ * @discussion This notification indicates that the peer was found and that
+ * the device is ready to communicate with it.
+ * @param transport The transport issuing the notification.
+ * @param peer Peer found.
+ */
+- (void)transport:(id<HYPTransport>)transport
+      didFindPeer:(id)peer;
+
+/**
+ * @abstract Notification issued when a peer is lost.
+ * @discussion This notification indicates that communicating with the peer
+ * is no longer possible.
+ * @param transport The transport issuing the notification.
+ * @param peer Peer lost.
+ */
+- (void)transport:(id<HYPTransport>)transport
+      didLosePeer:(id)peer;
+
+/**
+ * @abstract Notification issued when data arrives.
+ * @param transport The transport issuing the notification.
+ * @param data Data received.
+ * @param peer Peer that sent the data.
+ */
+- (void)transport:(id<HYPTransport>)transport
+   didReceiveData:(NSData *)data
+         fromPeer:(id)peer;
+
+/**
+ * @abstract Notification issued when a message is delivered.
+ * @discussion This notification indicates that the destination acknowledged
+ * the whole message.
+ * @param transport The transport issuing the notification.
+ * @param identifier Identifier returned when the message was sent.
+ */
+- (void)transport:(id<HYPTransport>)transport
+didDeliverMessageWithIdentifier:(NSUInteger)identifier;
+
+/**
+ * @abstract Notification issued when a message fails to be sent.
+ * @param transport The transport issuing the notification.
+ * @param identifier Identifier returned when the message was sent.
+ */
+- (void)transport:(id<HYPTransport>)transport
+didFailSendingMessageWithIdentifier:(NSUInteger)identifier;
+
+@end
@@ -24,67 +24,23 @@
 //
 
 #import <Foundation/Foundation.h>
-#import "HYPHypeControllerDelegate.h"
-#import "HYPTwilioChannel.h"
-#import "HYPTwilioMessage.h"
 #import <Hype/Hype.h>
+#import "HYPTransport.h"
 
 /**
  * @abstract Hype controller.
  * @discussion This controller has the purpose to control the hype
- * framework. The main responsabilities of this controller are: 
- * start hype framework, join an offline peer to a twilio channel,
- * send messages to a closer instance and foward messages from twilio
- * to a closer instance.
+ * framework. It implements the transport used by the bridge on top of
+ * Hype: it starts the framework, resolves the instances it finds and
+ * moves frames to and from them. Peers are HYPInstance objects.
  */
-@interface HYPHypeController : NSObject
+@interface HYPHypeController : NSObject <HYPTransport>
 
-@property (atomic, weak) id<HYPHypeControllerDelegate> delegate;
-
-
-/**
- * @abstract Requests Hype framework to start.
- * @discussion This method requests Hype framework to start.
- */
-- (void)requestHypeToStart;
-
-/**
- * @abstract Notification issued when identifier for vendor joins a channel.
- * @discussion This notification indicates that the given identifier for vendor
- * joined a channel with the given identity.
- * @param channel Channel that has been joined.
- * @param identifierForVendor Identifier for vendor of the device joined.
- * @param identity Identity of the device that joined the channel.
- */
-- (void)identifierForVendor:(NSString *)identifierForVendor
-             didjoinChannel:(HYPTwilioChannel *)channel
-               withIdentity:(NSString *)identity;
-
-/**
- * @abstract Sends a message to instance.
- * @discussion This method sends a message to a given instance.
- * @param instance Instance that will receive the message.
- * @param text Message to send.
- * @param identifierForVendor Peer identifier for vendor.
- */
-- (void)sendMessageToCloserInstance:(HYPInstance *)instance
-                           withText:(NSString *)text
-             identifierForVendor:(NSString *)identifierForVendor;
-
-/**
- * @abstract Forwards messages to saved instances.
- * @discussion This method fowards a messages to saved instances.
- * @param message Message that will be foward
- * @param instances Saved instances.
- */
-- (void)resendTwilioMessage:(NSMutableDictionary *)message
-                toInstances:(NSDictionary *)instances;
+@property (atomic, weak) id<HYPTransportDelegate> delegate;
 
 /**
- * @abstract Notifys class that it fails trying to connect to twilio.
- * @discussion This method notifys class when it fails trying to connect to twilio.
- * @param response Error response
+ * @abstract Main queue, on which the framework notifications are forwarded.
  */
-- (void)failConnecting:(NSString *)response;
+@property (atomic, readonly) dispatch_queue_t queue;
 
 @end
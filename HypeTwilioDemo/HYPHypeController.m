@@ -24,35 +24,15 @@
 //
 
 #import "HYPHypeController.h"
-#import <UIKit/UIKit.h>
-#import "HYPInstanceChannel.h"
 
 @interface HYPHypeController () <HYPStateObserver, HYPNetworkObserver, HYPMessageObserver>
 
-@property (atomic, readonly) HYPInstanceChannel * instanceChannel;
-@property (atomic) NSString * announcement;
-@property (nonatomic, assign) BOOL netAccess;
-
 @end
 
 @implementation HYPHypeController
-@synthesize instanceChannel = _instanceChannel;
-
-- (HYPInstanceChannel *)instanceChannel
-{
-
-    @synchronized(self) {
-
-        if (_instanceChannel == nil) {
-            _instanceChannel = [[HYPInstanceChannel alloc] init];
-
-        }
-        return _instanceChannel;
-    }
-}
 
 #pragma mark - Hype framework
-- (void)requestHypeToStart
+- (void)start
 {
     // Adding itself as an Hype state observer makes sure that the application gets
     // notifications for lifecycle events being triggered by the Hype framework. These
@@ -128,7 +108,7 @@
     // known to be highly likely. If the services are not needed at this point it's
     // possible to delay the execution for later, but it's not guaranteed that the
     // recovery conditions will still hold by then.
-    [self requestHypeToStart];
+    [self start];
 }
 
 - (void)hypeDidChangeState
@@ -149,8 +129,7 @@
         NSLog(@"Found instance: %@", [instance stringIdentifier]);
 
         if([instance isResolved]){
-            [self sendResponseToResolvedInstance:instance];
-            [self notifiyHypeControllerOnInstanceResolved:instance];
+            [self.delegate transport:self didFindPeer:instance];
         }
         else{
             [HYP resolveInstance:instance];
@@ -169,15 +148,17 @@
         // the adapters off, in which case not only are all instances lost but the framework
         // also stops with an error.
         NSLog(@"Lost instance: %@ [%@]", [instance stringIdentifier], [error description]);
-        [self notifiyHypeControllerOnInstanceLost:instance];
+        [self.delegate transport:self didLosePeer:instance];
     });
 }
 
 - (void)hypeDidResolveInstance:(HYPInstance *)instance
 {
-    NSLog(@"Instance resolved: %@", instance.stringIdentifier);
-    [self sendResponseToResolvedInstance:instance];
-    [self notifiyHypeControllerOnInstanceResolved:instance];
+    dispatch_async(dispatch_get_main_queue(), ^{
+
+        NSLog(@"Instance resolved: %@", instance.stringIdentifier);
+        [self.delegate transport:self didFindPeer:instance];
+    });
 }
 
 - (void)hypeDidFailResolvingInstance:(HYPInstance *)instance
@@ -186,105 +167,13 @@
     NSLog(@"Failed to resolve instance: %@ [%@]", instance.stringIdentifier, error.description);
 }
 
-- (void)sendMessageToCloserInstance:(HYPInstance *)instance
-                           withText:(NSString *)text
-             identifierForVendor:(NSString *)identifierForVendor
-{
-    NSMutableDictionary * sendMessage = [[NSMutableDictionary alloc] init];
-    [sendMessage setValue:text forKey:@"message"];
-    [sendMessage setValue:@"send" forKey:@"type"];
-    [sendMessage setValue:identifierForVendor forKey:@"identifierForVendor"];
-
-    NSData * data = [NSJSONSerialization dataWithJSONObject:sendMessage
-                                                    options:0
-                                                      error:nil];
-
-    [HYP sendData:data
-                  toInstance:instance
-               trackProgress:NO];
-}
-
-- (void)sendMessage:(NSMutableDictionary* )twilioMessage
-         toInstance:(HYPInstance *)instance
-{
-    NSMutableDictionary * dict = [[NSMutableDictionary alloc] init];
-    dict = twilioMessage;
-    if([dict objectForKey:@"type"] == nil)
-    {
-        [dict setValue:@"receive" forKey:@"type"];
-    }
-    NSData * data = [NSJSONSerialization dataWithJSONObject:dict
-                                                    options:0
-                                                      error:nil];
-
-    [HYP sendData:data
-                  toInstance:instance
-               trackProgress:NO];
-}
-
-- (void)processSendsWithResponse:(NSMutableDictionary *)response
-{
-    if ([self.delegate respondsToSelector:@selector(hypeController:didSendMessage:fromIdentifierVendor:)]) {
-
-        [self.delegate hypeController:self didSendMessage:[response objectForKey:@"message"] fromIdentifierVendor:[response objectForKey:@"identifierForVendor"]];
-
-    }
-}
-
-- (void)resendTwilioMessage:(NSMutableDictionary *)message
-                toInstances:(NSDictionary *)instances
-{
-
-    for (NSString* key in instances) {
-
-        HYPInstance *instance = [instances objectForKey:key];
-        [self sendMessage:message toInstance:instance];
-
-    }
-}
-
-- (void) processReceivesWithResponse:(NSMutableDictionary *)response
-{
-    if ([self.delegate respondsToSelector:@selector(hypeController:didReceiveMessage:)]) {
-
-        [self.delegate hypeController:self didReceiveMessage:response];
-
-    }
-}
-
 - (void)hypeDidReceiveMessage:(HYPMessage *)message
                  fromInstance:(HYPInstance *)fromInstance
 {
-    __strong HYPInstance * tmp_instance = [[HYPInstance alloc] init];
-    tmp_instance = fromInstance;
-
     dispatch_async(dispatch_get_main_queue(), ^{
 
         NSLog(@"Got a message from: %@", [fromInstance stringIdentifier]);
-
-        NSMutableDictionary *response = [NSJSONSerialization JSONObjectWithData:message.data
-                                                                        options:0
-                                                                          error:nil];
-
-        if ([[response objectForKey:@"type"] isEqualToString:@"announcement"] && [[response objectForKey:@"twilio"] isEqualToString:@"NO"]){
-
-            [self proccessAnnouncementResponsesWithDictionary:response instance:tmp_instance];
-
-        }else if ([[response objectForKey:@"type"] isEqualToString:@"announcement"] && [[response objectForKey:@"twilio"] isEqualToString:@"YES"]){
-
-            //
-        }else if ([[response objectForKey:@"type"] isEqualToString:@"client"]){
-
-            [self processClientWithResponse:response];
-
-        }else if ([[response objectForKey:@"type"] isEqualToString:@"send"]){
-
-            [self processSendsWithResponse:response];
-
-        }else if ([[response objectForKey:@"type"] isEqualToString:@"receive"]){
-
-            [self processReceivesWithResponse:response];
-        }
+        [self.delegate transport:self didReceiveData:message.data fromPeer:fromInstance];
     });
 }
 
@@ -296,7 +185,11 @@
     // (Bluetooth and Wi-Fi) being turned off by the user while the process
     // of sending the data is still ongoing. The error parameter describes
     // the cause for the failure.
-    NSLog(@"Failed to send message: %lu [%@]", (unsigned long)messageInfo.identifier, [error description]);
+    dispatch_async(dispatch_get_main_queue(), ^{
+
+        NSLog(@"Failed to send message: %lu [%@]", (unsigned long)messageInfo.identifier, [error description]);
+        [self.delegate transport:self didFailSendingMessageWithIdentifier:messageInfo.identifier];
+    });
 }
 
 - (void)hypeDidSendMessage:(HYPMessageInfo *)messageInfo
@@ -322,6 +215,12 @@
     // has been fully delivered and the content is available on the destination
     // device. This method is useful for implementing progress bars.
     NSLog(@"Message being delivered: %f", progress);
+
+    if (complete) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self.delegate transport:self didDeliverMessageWithIdentifier:messageInfo.identifier];
+        });
+    }
 }
 
 - (NSString *)hypeDidRequestAccessTokenWithUserIdentifier:(NSUInteger)userIdentifier
@@ -332,96 +231,28 @@
     return @"";
 }
 
-#pragma mark - Notify bridge
-
-- (void)identifierForVendor:(NSString *)identifierForVendor
-             didjoinChannel:(HYPTwilioChannel *)channel
-               withIdentity:(NSString *)identity
-{
-    HYPInstance * instance = [self.instanceChannel instanceWithIdentifierVendor:identifierForVendor];
-    [self.instanceChannel setChannel:channel forIdentifierVendor:identifierForVendor];
-    NSMutableDictionary * channelDict = [[NSMutableDictionary alloc]init];
-    [channelDict setValue:@"client"forKey:@"type"];
-    [channelDict setValue:identity forKey:@"identity"];
-
-    NSData * data = [NSJSONSerialization dataWithJSONObject:channelDict
-                                                    options:0
-                                                      error:nil];
-
-    [HYP sendData:data
-                  toInstance:instance
-               trackProgress:NO];
-}
-
-#pragma mark - Hype framework Manager
-
-- (void)proccessAnnouncementResponsesWithDictionary:(NSMutableDictionary *)response
-                                        instance:(HYPInstance *)instance
-{
-    if ([self.delegate respondsToSelector:@selector(hypeController:requestTwilioClient:)]) {
-
-        [self.instanceChannel setInstance:instance forIdentifierVendor:[response objectForKey:@"vendorIdentifier"]];
-
-        [self.delegate hypeController:self requestTwilioClient:[response objectForKey:@"vendorIdentifier"]];
-
-    }
-}
-
-- (void)processClientWithResponse:(NSMutableDictionary * )response
-{
-    self.announcement = @"MIM";
-
-    if ([self.delegate respondsToSelector:@selector(hypeController:didJoinTwilio:)]) {
+#pragma mark - Transport
 
-        [self.delegate hypeController:self didJoinTwilio:response];
-
-    }
-}
-
-- (void)failConnecting:(NSString *)response
+- (dispatch_queue_t)queue
 {
-    self.netAccess = false;
+    return dispatch_get_main_queue();
 }
 
--(void)sendResponseToResolvedInstance:(HYPInstance *)instance
+- (NSUInteger)sendData:(NSData *)data
+                toPeer:(id)peer
 {
-    NSMutableDictionary *response = [[NSMutableDictionary alloc] init];
-    // Hype instances that are participating on the network are identified by a full
-    // UUID, composed by the vendor's identifier followed by a unique identifier generated
-    // for each instance.
-    NSString *identifierForVendor = [[[UIDevice currentDevice] identifierForVendor] UUIDString];
-    [response setValue:@"announcement" forKey:@"type"];
-
-    if(self.netAccess){
-        [response setValue:@"YES" forKey:@"twilio"];
-    }else{
-        [response setValue:@"NO" forKey:@"twilio"];
-    }
+    // Progress tracking is required for the framework to issue the delivery
+    // notifications that release frames from the send window.
+    HYPMessage * message = [HYP sendData:data
+                              toInstance:peer
+                           trackProgress:YES];
 
-    [response setValue:identifierForVendor forKey:@"vendorIdentifier"];
-
-    NSData * data = [NSJSONSerialization dataWithJSONObject:response
-                                                    options:0 error:nil];
-
-    [HYP sendData:data toInstance:instance trackProgress:NO];
-}
-
--(void)notifiyHypeControllerOnInstanceResolved:(HYPInstance *)instance
-{
-    NSString *identifierForVendor = [[[UIDevice currentDevice] identifierForVendor] UUIDString];
-    if ([self.delegate respondsToSelector:@selector(hypeController:didFoundInstance:withIdentifierForVendor:)]) {
-        [self.delegate hypeController:self didFoundInstance:instance withIdentifierForVendor:identifierForVendor];
-    }
+    return message.identifier;
 }
 
--(void)notifiyHypeControllerOnInstanceLost:(HYPInstance *)instance
+- (NSString *)identifierForPeer:(id)peer
 {
-    if ([self.delegate respondsToSelector:@selector(hypeController:didLoseInstance:)]) {
-
-        [self.delegate hypeController:self didLoseInstance:instance ];
-
-    }
+    return [(HYPInstance *)peer stringIdentifier];
 }
 
-
 @end
@@ -24,7 +24,7 @@
 //
 
 #import <Foundation/Foundation.h>
-#import "HYPTwilioControllerDelegate.h"
+#import "HYPChatBackend.h"
 
 /**
  * @abstract Twilio controller.
@@ -32,17 +32,18 @@
  * of the twilio Api calls. The main responsabilities of this
  * controller are: generate twilio clients, send messages
  * to a twilio channel and receive messages from a twilio channel.
+ * Channels handed to the delegate are HYPTwilioChannel objects.
  */
-@interface HYPTwilioController : NSObject
+@interface HYPTwilioController : NSObject <HYPChatBackend>
 
-@property (atomic, weak) id<HYPTwilioControllerDelegate> delegate;
+@property (atomic, weak) id<HYPChatBackendDelegate> delegate;
 
 /**
  * @abstract Generates a twilio client.
  * @discussion This method generates a twilio client with the given identifier.
  * @param identifierForVendor The identifier to assign.
  */
-- (void)generateTwilioClientWithIdentifierForVendor:(NSString *)identifierForVendor;
+- (void)generateClientWithIdentifierForVendor:(NSString *)identifierForVendor;
 
 /**
  * @abstract Sends a message to twilio channel.
@@ -50,7 +51,20 @@
  * @param channel channel to send.
  * @param text message to send.
  */
-- (void)sendMessageToTwilioToChannel:(HYPTwilioChannel *)channel
-                             withText:(NSString *)text;
+- (void)sendMessageToChannel:(HYPTwilioChannel *)channel
+                    withText:(NSString *)text;
+
+/**
+ * @abstract Fetches a page of twilio channel history.
+ * @discussion This method fetches the newest messages below the given index.
+ * @param channel channel to read.
+ * @param index exclusive upper bound of the page, or nil for the newest page.
+ * @param count maximum number of messages in the page.
+ * @param completion called with the page, or nil on failure.
+ */
+- (void)fetchMessagesFromChannel:(HYPTwilioChannel *)channel
+                     beforeIndex:(NSNumber *)index
+                       withCount:(NSUInteger)count
+                      completion:(void (^)(NSArray * messages))completion;
 
 @end
@@ -50,7 +50,7 @@
     return _clientDictionary;
 }
 
-- (void)generateTwilioClientWithIdentifierForVendor:(NSString * )identifierForVendor
+- (void)generateClientWithIdentifierForVendor:(NSString * )identifierForVendor
 {
     NSString *tokenEndpoint = @"http://localhost:5000/token?device=%@";
     NSString *urlString = [NSString stringWithFormat:tokenEndpoint, identifierForVendor];
@@ -72,18 +72,18 @@
                 
             } else {
                 
-                if ([self.delegate respondsToSelector:@selector(twilioController:failConnecting:)]) {
+                if ([self.delegate respondsToSelector:@selector(chatBackend:failConnecting:)]) {
                 
-                    [self.delegate twilioController:self failConnecting:@"error"];
+                    [self.delegate chatBackend:self failConnecting:@"error"];
                     
                 }
                 NSLog(@"ViewController viewDidLoad: error parsing token from server");
             }
         } else {
             
-            if ([self.delegate respondsToSelector:@selector(twilioController:failConnecting:)]) {
+            if ([self.delegate respondsToSelector:@selector(chatBackend:failConnecting:)]) {
                 
-                [self.delegate twilioController:self failConnecting:@"Error"];
+                [self.delegate chatBackend:self failConnecting:@"Error"];
                 
             }
             NSLog(@"ViewController viewDidLoad: error fetching token from server");
@@ -120,10 +120,10 @@ synchronizationStatusChanged:(TCHClientSynchronizationStatus)status {
                         
                         HYPTwilioChannel * hypTwilioChannel = [[HYPTwilioChannel alloc] initWithTwilioChannel:channel];
                         
-                        if ([self.delegate respondsToSelector:@selector(twilioController:didJoinChannel:withIdentifierForVendor:identity:)]) {
-                            [self.delegate twilioController:self
-                                             didJoinChannel:hypTwilioChannel
-                                    withIdentifierForVendor:identifierForVendor identity:identity];
+                        if ([self.delegate respondsToSelector:@selector(chatBackend:didJoinChannel:withIdentifierForVendor:identity:)]) {
+                            [self.delegate chatBackend:self
+                                        didJoinChannel:hypTwilioChannel
+                               withIdentifierForVendor:identifierForVendor identity:identity];
                         }
                     }];
                 });
@@ -145,39 +145,96 @@ synchronizationStatusChanged:(TCHClientSynchronizationStatus)status {
     }
 }
 
+- (NSMutableDictionary *)dictionaryWithMessage:(TCHMessage *)message
+{
+    NSMutableDictionary * receivedMessage = [[NSMutableDictionary alloc] init];
+    [receivedMessage setValue:message.sid forKey:@"sid"];
+    [receivedMessage setValue:message.author forKey:@"author"];
+    [receivedMessage setValue:message.body forKey:@"body"];
+    [receivedMessage setValue:message.index forKey:@"index"];
+    [receivedMessage setValue:@([message.timestampAsDate timeIntervalSince1970]) forKey:@"timestamp"];
+    
+    return receivedMessage;
+}
+
 // Receive messages
 - (void)chatClient:(TwilioChatClient *)client
            channel:(TCHChannel *)channel
       messageAdded:(TCHMessage *)message
 {
-    HYPTwilioMessage * hypMessage = [[HYPTwilioMessage alloc] initWithTwilioMessage:message];
-    if ([self.delegate respondsToSelector:@selector(twilioController:didReceiveMessage:)]) {
+    NSMutableDictionary * receivedMessage = [self dictionaryWithMessage:message];
+    if ([self.delegate respondsToSelector:@selector(chatBackend:didReceiveMessage:)]) {
         
-        [self.delegate twilioController:self didReceiveMessage:hypMessage];
+        [self.delegate chatBackend:self didReceiveMessage:receivedMessage];
         
     }
 }
 
 // Send messages
-- (void)sendMessageToTwilioToChannel:(HYPTwilioChannel *)channel
-                             withText:(NSString *)text
+- (void)sendMessageToChannel:(HYPTwilioChannel *)channel
+                    withText:(NSString *)text
 {
     TCHMessage *message = [channel.twilioChannel.messages createMessageWithBody:text];
     [channel.twilioChannel.messages sendMessage:message completion:^(TCHResult *result) {
         if (!result.isSuccessful) {
             NSLog(@"Message not sent.");
-            if ([self.delegate respondsToSelector:@selector(twilioController:didSendMessage:)]) {
-                [self.delegate twilioController:self didSendMessage:@"Error"];
+            if ([self.delegate respondsToSelector:@selector(chatBackend:didSendMessage:)]) {
+                [self.delegate chatBackend:self didSendMessage:@"Error"];
                 
             }
         }else{
             NSLog(@"Message sent.");
-            if ([self.delegate respondsToSelector:@selector(twilioController:didSendMessage:)]) {
-                [self.delegate twilioController:self didSendMessage:@"Success"];
+            if ([self.delegate respondsToSelector:@selector(chatBackend:didSendMessage:)]) {
+                [self.delegate chatBackend:self didSendMessage:@"Success"];
                 
             }
         }
     }];
 }
 
+- (NSString *)identifierForChannel:(HYPTwilioChannel *)channel
+{
+    return channel.twilioChannel.sid;
+}
+
+// Fetch history
+- (void)fetchMessagesFromChannel:(HYPTwilioChannel *)channel
+                     beforeIndex:(NSNumber *)index
+                       withCount:(NSUInteger)count
+                      completion:(void (^)(NSArray * messages))completion
+{
+    void (^pageCompletion)(TCHResult *, NSArray *) = ^(TCHResult *result, NSArray *messages) {
+        
+        if (!result.isSuccessful) {
+            NSLog(@"History page not fetched.");
+            completion(nil);
+            return;
+        }
+        
+        NSMutableArray * page = [[NSMutableArray alloc] init];
+        
+        for (TCHMessage * message in messages) {
+            [page addObject:[self dictionaryWithMessage:message]];
+        }
+        
+        completion(page);
+    };
+    
+    if (index == nil) {
+        
+        [channel.twilioChannel.messages getLastMessagesWithCount:count completion:pageCompletion];
+        
+    } else if (index.unsignedIntegerValue == 0) {
+        
+        completion(@[]);
+        
+    } else {
+        
+        // Twilio pages include the message at the given index.
+        [channel.twilioChannel.messages getMessagesBefore:index.unsignedIntegerValue - 1
+                                                withCount:count
+                                               completion:pageCompletion];
+    }
+}
+
 @end
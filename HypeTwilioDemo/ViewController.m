@@ -26,9 +26,13 @@
 #import "ViewController.h"
 #import <TwilioChatClient/TwilioChatClient.h>
 #import "HYPBridgeController.h"
+#import "HYPHypeController.h"
+#import "HYPSearchIndex.h"
+#import "HYPTwilioController.h"
+#import "HYPTwilioChannel.h"
 
 #pragma mark - Interface
-@interface ViewController () <UITableViewDelegate, UITableViewDataSource, TwilioChatClientDelegate, UITextFieldDelegate, HYPBridgeControllerDelegate>
+@interface ViewController () <UITableViewDelegate, UITableViewDataSource, TwilioChatClientDelegate, UITextFieldDelegate, UISearchBarDelegate, HYPBridgeControllerDelegate>
 
 #pragma mark - IP Messaging Members
 @property (strong, nonatomic) NSMutableOrderedSet *messages;
@@ -38,10 +42,15 @@
 @property (strong, nonatomic) HYPTwilioChannel *channel;
 @property (nonatomic, assign) BOOL netAccess;
 
+#pragma mark - Search Members
+@property (atomic, readonly) HYPSearchIndex *searchIndex;
+@property (strong, nonatomic) NSArray *searchResults;
+
 #pragma mark - UI Elements
 @property (weak, nonatomic) IBOutlet NSLayoutConstraint *bottomConstraint;
 @property (weak, nonatomic) IBOutlet UITableView *tableView;
 @property (weak, nonatomic) IBOutlet UITextField *textField;
+@property (strong, nonatomic) UISearchBar *searchBar;
 @property (atomic, readonly) HYPBridgeController * bridgeController;
 
 @end
@@ -50,6 +59,7 @@
 
 @implementation ViewController
 @synthesize bridgeController = _bridgeController;
+@synthesize searchIndex = _searchIndex;
 
 - (HYPBridgeController *)hypBridgeController
 {
@@ -57,13 +67,31 @@
     @synchronized(self) {
         
         if (_bridgeController == nil) {
-            _bridgeController = [[HYPBridgeController alloc] init];
+            NSString *identifierForVendor = [[[UIDevice currentDevice] identifierForVendor] UUIDString];
+            _bridgeController = [[HYPBridgeController alloc] initWithIdentifierForVendor:identifierForVendor
+                                                                               transport:[[HYPHypeController alloc] init]
+                                                                             chatBackend:[[HYPTwilioController alloc] init]];
             _bridgeController.delegate = self;
             
         }
         return _bridgeController;
     }
 }
+
+- (HYPSearchIndex *)searchIndex
+{
+    @synchronized(self) {
+        
+        if (_searchIndex == nil) {
+            HYPMessageStore *messageStore = self.hypBridgeController.messageStore;
+            NSString *path = [[messageStore.path stringByDeletingPathExtension] stringByAppendingPathExtension:@"index"];
+            _searchIndex = [[HYPSearchIndex alloc] initWithMessageStore:messageStore
+                                                                   path:path];
+        }
+        return _searchIndex;
+    }
+}
+
 #pragma mark - Lifecycle
 
 - (instancetype)initWithCoder:(NSCoder *)aDecoder {
@@ -97,6 +125,13 @@
     // text field
     self.textField.delegate = self;
     
+    // Search bar
+    self.searchBar = [[UISearchBar alloc] init];
+    self.searchBar.placeholder = @"Search messages";
+    self.searchBar.delegate = self;
+    [self.searchBar sizeToFit];
+    self.tableView.tableHeaderView = self.searchBar;
+    
     // Dodge Keyboard when text field is selected
     [[NSNotificationCenter defaultCenter] addObserver:self
                                              selector:@selector(keyboardWillShow:)
@@ -113,15 +148,24 @@
                                                  name:UIKeyboardWillHideNotification
                                                object:self.view.window];
     
+    // Checkpoint the search index before the app may be killed
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(applicationDidEnterBackground:)
+                                                 name:UIApplicationDidEnterBackgroundNotification
+                                               object:nil];
+    
     [self requestOwnTwilioClient];
     [self requestHypeToStart];
     
+    // Catch up with the messages stored on earlier launches
+    [self.searchIndex update];
+    
 }
 
 - (void)requestHypeToStart
 {
     // Initialize Hype Framework
-    [self.hypBridgeController requestHypeToStart];
+    [self.hypBridgeController requestMeshToStart];
     
 }
 
@@ -133,8 +177,12 @@
 }
 
 #pragma mark - UI Helpers
+- (NSArray *)displayedMessages {
+    return self.searchResults != nil ? self.searchResults : self.messages.array;
+}
+
 - (void)scrollToBottomMessage {
-    if (self.messages.count == 0) {
+    if ([self displayedMessages].count == 0) {
         return;
     }
     
@@ -151,6 +199,7 @@
     
     [self.messages addObjectsFromArray:@[message]];
     [self sortMessages];
+    [self.searchIndex update];
     dispatch_async(dispatch_get_main_queue(), ^{
         [self.tableView reloadData];
         if (self.messages.count > 0) {
@@ -182,6 +231,24 @@
     [self.view setNeedsLayout];
 }
 
+- (void)applicationDidEnterBackground:(NSNotification *)notification {
+    UIApplication *application = [UIApplication sharedApplication];
+    __block UIBackgroundTaskIdentifier task;
+    
+    // Ask for time to finish the save; the app is suspended otherwise
+    task = [application beginBackgroundTaskWithExpirationHandler:^{
+        [application endBackgroundTask:task];
+        task = UIBackgroundTaskInvalid;
+    }];
+    
+    [self.searchIndex saveWithCompletion:^{
+        if (task != UIBackgroundTaskInvalid) {
+            [application endBackgroundTask:task];
+            task = UIBackgroundTaskInvalid;
+        }
+    }];
+}
+
 - (IBAction)viewTapped:(id)sender {
     [self.textField resignFirstResponder];
 }
@@ -194,7 +261,7 @@
     UITableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:@"MessageCell"
                                                             forIndexPath:indexPath];
     
-    NSMutableDictionary *message = [self.messages objectAtIndex:indexPath.row];
+    NSMutableDictionary *message = [[self displayedMessages] objectAtIndex:indexPath.row];
     
     cell.detailTextLabel.text = [message objectForKey:@"author"];
     cell.textLabel.text = [message objectForKey:@"body"];
@@ -208,7 +275,45 @@
 
 - (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section
 {
-    return self.messages.count;
+    return [self displayedMessages].count;
+}
+
+- (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section
+{
+    if (self.searchResults == nil) {
+        return nil;
+    }
+    
+    return [NSString stringWithFormat:@"%lu results in %.1f ms",
+            (unsigned long)self.searchResults.count,
+            self.searchIndex.lastQueryInterval * 1000];
+}
+
+#pragma mark - UISearchBarDelegate
+
+- (void)searchBar:(UISearchBar *)searchBar textDidChange:(NSString *)searchText
+{
+    if (searchText.length == 0) {
+        self.searchResults = nil;
+        [self.tableView reloadData];
+        return;
+    }
+    
+    [self.searchIndex searchWithQuery:searchText limit:100 completion:^(NSArray *messages) {
+        
+        // Results of a query the user typed past are dropped
+        if (![searchBar.text isEqualToString:searchText]) {
+            return;
+        }
+        
+        self.searchResults = messages;
+        [self.tableView reloadData];
+    }];
+}
+
+- (void)searchBarSearchButtonClicked:(UISearchBar *)searchBar
+{
+    [searchBar resignFirstResponder];
 }
 
 #pragma mark - UITextFieldDelegate
@@ -244,12 +349,12 @@
 }
 
 - (void)bridgeController:(HYPBridgeController *)bridgeController
-          didJoinChannel:(HYPTwilioChannel *)channel
+          didJoinChannel:(id)channel
             withIdentity:(NSString *)identity
 {
     
     
-    HYPTwilioChannel * hypTwilioChannel = [[HYPTwilioChannel alloc] initWithTwilioChannel:channel.twilioChannel];
+    HYPTwilioChannel * hypTwilioChannel = [[HYPTwilioChannel alloc] initWithTwilioChannel:((HYPTwilioChannel *)channel).twilioChannel];
     self.channel = hypTwilioChannel;
     self.navigationItem.prompt = [NSString stringWithFormat:@"Logged in as %@",identity];
     self.netAccess = true;
@@ -290,4 +395,12 @@
     
 }
 
+- (void)bridgeController:(HYPBridgeController *)bridgeController
+     didBackfillMessages:(NSArray *)messages
+{
+    // Older pages are never shown, so they are indexed from here
+    [self.searchIndex update];
+    
+}
+
 @end
@@ -0,0 +1,80 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPMeshControllerDelegate.h"
+
+/**
+ * @abstract Catch-up simulation.
+ * @discussion This class measures how a gateway that was out of range
+ * catches up with another one. It runs two mesh controllers over UDP on the
+ * loopback interface, each with an in-memory message store. Both stores hold
+ * the same shared history, and the first one also holds a gap of messages
+ * the second one missed. Once the gateways meet, the simulation waits until
+ * the second store holds every message and reports the reconciliation bytes
+ * each side sent and the time it took.
+ */
+@interface HYPCatchUpSimulation : NSObject <HYPMeshControllerDelegate>
+
+/**
+ * @abstract Number of messages both gateways hold.
+ */
+@property (atomic) NSUInteger historyCount;
+
+/**
+ * @abstract Number of messages only the first gateway holds.
+ */
+@property (atomic) NSUInteger gapCount;
+
+/**
+ * @abstract Probability of dropping an outgoing datagram.
+ */
+@property (atomic) double lossRate;
+
+/**
+ * @abstract Seed of the generated sids and of the simulated loss.
+ * @discussion Zero, the default, picks a random seed.
+ */
+@property (atomic) uint64_t seed;
+
+/**
+ * @abstract Port of the first gateway; the second one uses the next port.
+ */
+@property (atomic) uint16_t port;
+
+/**
+ * @abstract Time after which the simulation gives up.
+ */
+@property (atomic) NSTimeInterval timeout;
+
+/**
+ * @abstract Starts the simulation.
+ * @discussion This method returns immediately. The completion is called
+ * once the second gateway caught up or the timeout elapsed.
+ * @param completion Block called with whether the gateway caught up.
+ */
+- (void)startWithCompletion:(void (^)(BOOL caughtUp))completion;
+
+@end
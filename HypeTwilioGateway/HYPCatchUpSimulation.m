@@ -0,0 +1,288 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPCatchUpSimulation.h"
+#import "HYPMeshController.h"
+#import "HYPMessageStore.h"
+#import "HYPUDPTransport.h"
+
+@interface HYPCatchUpSimulation ()
+
+@property (atomic) HYPMeshController * upToDateController;
+@property (atomic) HYPMeshController * laggingController;
+@property (atomic) HYPUDPTransport * upToDateTransport;
+@property (atomic) HYPUDPTransport * laggingTransport;
+@property (atomic) dispatch_source_t pollTimer;
+@property (atomic, copy) void (^completion)(BOOL caughtUp);
+@property (atomic) NSDate * foundDate;
+@property (atomic) NSDate * caughtUpDate;
+@property (atomic) BOOL finished;
+
+@end
+
+@implementation HYPCatchUpSimulation
+
+- (instancetype)init
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _historyCount = 10000;
+        _gapCount = 100;
+        _port = 7900;
+        _timeout = 60.0;
+    }
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_pollTimer != nil) {
+        dispatch_source_cancel(_pollTimer);
+    }
+}
+
+#pragma mark - Setup
+
+- (NSDictionary *)generatedMessageWithIndex:(NSUInteger)index
+{
+    // Sids follow the Twilio format; random ones spread the gap over the
+    // whole sid space, as messages from many gateways would.
+    NSString * sid = [NSString stringWithFormat:@"IM%08lx%08lx%08lx%08lx",
+                      (unsigned long)(mrand48() & 0xffffffff),
+                      (unsigned long)(mrand48() & 0xffffffff),
+                      (unsigned long)(mrand48() & 0xffffffff),
+                      (unsigned long)(mrand48() & 0xffffffff)];
+    
+    return @{ @"sid" : sid,
+              @"author" : [NSString stringWithFormat:@"user-%02lu", (unsigned long)(index % 32)],
+              @"body" : [NSString stringWithFormat:@"Simulated message number %lu", (unsigned long)index],
+              @"index" : @(index),
+              @"timestamp" : @(1500000000 + index) };
+}
+
+- (HYPMeshController *)controllerWithTransport:(HYPUDPTransport *)transport
+                           identifierForVendor:(NSString *)identifierForVendor
+                                  messageStore:(HYPMessageStore *)messageStore
+{
+    HYPMeshController * controller = [[HYPMeshController alloc] initWithTransport:transport
+                                                              identifierForVendor:identifierForVendor];
+    controller.delegate = self;
+    controller.messageStore = messageStore;
+    
+    return controller;
+}
+
+- (void)startWithCompletion:(void (^)(BOOL caughtUp))completion
+{
+    self.completion = completion;
+    
+    if (self.seed != 0) {
+        srand48((long)self.seed);
+    } else {
+        srand48((long)time(NULL));
+    }
+    
+    // Stores without a path stay in memory, so runs do not leave files.
+    HYPMessageStore * upToDateStore = [[HYPMessageStore alloc] initWithPath:nil];
+    HYPMessageStore * laggingStore = [[HYPMessageStore alloc] initWithPath:nil];
+    
+    for (NSUInteger index = 0; index < self.historyCount + self.gapCount; index++) {
+        
+        NSDictionary * message = [self generatedMessageWithIndex:index];
+        
+        [upToDateStore addMessage:message];
+        
+        if (index < self.historyCount) {
+            [laggingStore addMessage:message];
+        }
+    }
+    
+    dispatch_queue_t upToDateQueue = dispatch_queue_create("com.hypelabs.catchup.uptodate", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_t laggingQueue = dispatch_queue_create("com.hypelabs.catchup.lagging", DISPATCH_QUEUE_SERIAL);
+    
+    self.upToDateTransport = [[HYPUDPTransport alloc] initWithPort:self.port queue:upToDateQueue];
+    self.laggingTransport = [[HYPUDPTransport alloc] initWithPort:self.port + 1 queue:laggingQueue];
+    self.upToDateTransport.lossRate = self.lossRate;
+    self.laggingTransport.lossRate = self.lossRate;
+    
+    // The lagging gateway comes back into range and greets the other one.
+    [self.laggingTransport addPeerWithAddress:[NSString stringWithFormat:@"127.0.0.1:%u", self.port]];
+    
+    self.upToDateController = [self controllerWithTransport:self.upToDateTransport
+                                        identifierForVendor:@"catchup-a"
+                                               messageStore:upToDateStore];
+    self.laggingController = [self controllerWithTransport:self.laggingTransport
+                                       identifierForVendor:@"catchup-b"
+                                              messageStore:laggingStore];
+    
+    NSLog(@"Simulating catch-up of %lu messages over %lu shared ones [loss %.2f]",
+          (unsigned long)self.gapCount,
+          (unsigned long)self.historyCount,
+          self.lossRate);
+    
+    [self.upToDateController start];
+    [self.laggingController start];
+    
+    __weak HYPCatchUpSimulation * weakSelf = self;
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+    dispatch_source_set_timer(timer, DISPATCH_TIME_NOW, NSEC_PER_MSEC * 10, NSEC_PER_MSEC);
+    dispatch_source_set_event_handler(timer, ^{
+        [weakSelf poll];
+    });
+    dispatch_resume(timer);
+    self.pollTimer = timer;
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.timeout * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [weakSelf finish];
+    });
+}
+
+#pragma mark - Measurement
+
+- (void)poll
+{
+    if (self.foundDate == nil || self.caughtUpDate != nil) {
+        return;
+    }
+    
+    if (self.laggingController.messageStore.count < self.historyCount + self.gapCount) {
+        return;
+    }
+    
+    self.caughtUpDate = [NSDate date];
+    dispatch_source_cancel(self.pollTimer);
+    
+    // Frames still in flight once the store is complete, such as the last
+    // sync replies, are part of the cost; they are counted after a pause.
+    __weak HYPCatchUpSimulation * weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)NSEC_PER_SEC), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [weakSelf finish];
+    });
+}
+
+- (void)finish
+{
+    @synchronized(self) {
+        
+        if (self.finished) {
+            return;
+        }
+        
+        self.finished = YES;
+    }
+    
+    NSUInteger upToDateBytes = self.upToDateController.reconciliationBytes;
+    NSUInteger laggingBytes = self.laggingController.reconciliationBytes;
+    NSUInteger datagrams = self.upToDateTransport.sentDatagrams + self.laggingTransport.sentDatagrams;
+    BOOL caughtUp = self.caughtUpDate != nil;
+    
+    if (caughtUp) {
+        
+        NSLog(@"Caught up %lu messages over %lu shared ones in %.1f ms [%lu bytes sent by the up to date gateway, %lu by the lagging one, %.1f bytes per missing message, %lu datagrams]",
+              (unsigned long)self.gapCount,
+              (unsigned long)self.historyCount,
+              [self.caughtUpDate timeIntervalSinceDate:self.foundDate] * 1000,
+              (unsigned long)upToDateBytes,
+              (unsigned long)laggingBytes,
+              (double)(upToDateBytes + laggingBytes) / MAX(self.gapCount, 1),
+              (unsigned long)datagrams);
+        
+    } else {
+        
+        NSLog(@"Gave up after %.0f s with %lu of %lu messages [%lu bytes sent by the up to date gateway, %lu by the lagging one, %lu datagrams]",
+              self.timeout,
+              (unsigned long)self.laggingController.messageStore.count,
+              (unsigned long)(self.historyCount + self.gapCount),
+              (unsigned long)upToDateBytes,
+              (unsigned long)laggingBytes,
+              (unsigned long)datagrams);
+    }
+    
+    if (self.completion != nil) {
+        self.completion(caughtUp);
+    }
+}
+
+#pragma mark - Mesh Delegates
+
+- (void)meshController:(HYPMeshController *)meshController
+   requestTwilioClient:(NSString *)identifierForVendor
+{
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+         didJoinTwilio:(NSMutableDictionary *)response
+{
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+        didSendMessage:(NSString *)message
+  fromIdentifierVendor:(NSString *)identifierVendor
+{
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+      didFoundInstance:(id)instance
+withIdentifierForVendor:(NSString *)identifierForVendor
+{
+    // Catch-up time is counted from the moment the gateways meet.
+    @synchronized(self) {
+        
+        if (self.foundDate == nil) {
+            self.foundDate = [NSDate date];
+        }
+    }
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+        didFindGateway:(id)instance
+{
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+       didLoseInstance:(id)instance
+{
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+     didReceiveMessage:(NSMutableDictionary *)message
+{
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+     didRecoverMessage:(NSMutableDictionary *)message
+{
+}
+
+- (id)meshController:(HYPMeshController *)meshController
+alternateInstanceForLostInstance:(id)instance
+{
+    return nil;
+}
+
+@end
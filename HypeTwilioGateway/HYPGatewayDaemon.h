@@ -0,0 +1,90 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPBridgeControllerDelegate.h"
+
+/**
+ * @abstract Gateway daemon.
+ * @discussion This class runs the bridge headless, for powered gateway boxes
+ * that serve offline phones at a venue. It starts one shard per core; each
+ * shard owns a serial queue, a UDP transport bound to the shared port and a
+ * bridge, so shards never contend for bridge state. All shards post to the
+ * same local chat server, which stands in for Twilio, and to the same
+ * message store, so peers catch up with whatever any shard has seen.
+ */
+@interface HYPGatewayDaemon : NSObject <HYPBridgeControllerDelegate>
+
+/**
+ * @abstract UDP port the shards listen on.
+ */
+@property (atomic) uint16_t port;
+
+/**
+ * @abstract Number of shards. Defaults to the number of active cores.
+ */
+@property (atomic) NSUInteger shardCount;
+
+/**
+ * @abstract Addresses of peers to greet on start, as "host:port" strings.
+ */
+@property (atomic, copy) NSArray * peerAddresses;
+
+/**
+ * @abstract Path of the message store shared by the shards.
+ * @discussion Defaults to the store's default path.
+ */
+@property (atomic, copy) NSString * storePath;
+
+/**
+ * @abstract Probability of dropping an outgoing datagram.
+ */
+@property (atomic) double lossRate;
+
+/**
+ * @abstract Seed of the local chat server and of the simulated loss.
+ * @discussion Runs with the same nonzero seed post the same sids and drop
+ * the same datagrams. Zero, the default, picks a random seed.
+ */
+@property (atomic) uint64_t seed;
+
+/**
+ * @abstract Number of generated messages posted to the channel on start.
+ */
+@property (atomic) NSUInteger historyCount;
+
+/**
+ * @abstract Interval between statistics reports, in seconds.
+ */
+@property (atomic) NSTimeInterval statisticsInterval;
+
+/**
+ * @abstract Starts the shards.
+ * @discussion This method returns immediately; the caller is expected to
+ * park the main thread, for instance with dispatch_main().
+ */
+- (void)start;
+
+@end
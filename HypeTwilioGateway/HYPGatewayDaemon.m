@@ -0,0 +1,270 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPGatewayDaemon.h"
+#import "HYPBridgeController.h"
+#import "HYPLocalChatBackend.h"
+#import "HYPLocalChatServer.h"
+#import "HYPMessageStore.h"
+#import "HYPUDPTransport.h"
+
+@interface HYPGatewayDaemon ()
+
+@property (atomic) HYPLocalChatServer * server;
+@property (strong, atomic, readonly) NSMutableArray * bridges;
+@property (strong, atomic, readonly) NSMutableArray * transports;
+@property (atomic) dispatch_source_t statisticsTimer;
+@property (atomic) NSUInteger lastMessageCount;
+@property (atomic) NSUInteger lastDatagramCount;
+
+@end
+
+@implementation HYPGatewayDaemon
+@synthesize bridges = _bridges;
+@synthesize transports = _transports;
+
+- (instancetype)init
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _bridges = [NSMutableArray new];
+        _transports = [NSMutableArray new];
+        _port = 7878;
+        _shardCount = [[NSProcessInfo processInfo] activeProcessorCount];
+        _statisticsInterval = 10.0;
+    }
+    
+    return self;
+}
+
+- (void)start
+{
+    if (self.seed != 0) {
+        self.server = [[HYPLocalChatServer alloc] initWithSeed:self.seed];
+        srand48((long)self.seed);
+    } else {
+        self.server = [[HYPLocalChatServer alloc] init];
+    }
+    
+    [self.server postHistoryWithCount:self.historyCount];
+    self.lastMessageCount = self.server.messageCount;
+    
+    NSString * gatewayIdentifier = [[NSUUID UUID] UUIDString];
+    
+    // Shards share the port, and peers greeted by the first shard are
+    // answered by another one, so they must all greet with the same session.
+    uuid_t sessionBytes;
+    uint32_t session;
+    [[NSUUID UUID] getUUIDBytes:sessionBytes];
+    memcpy(&session, sessionBytes, sizeof(session));
+    
+    NSString * storePath = self.storePath != nil ? self.storePath : [HYPMessageStore defaultPath];
+    HYPMessageStore * messageStore = [[HYPMessageStore alloc] initWithPath:storePath];
+    
+    for (NSUInteger shard = 0; shard < MAX(self.shardCount, 1); shard++) {
+        
+        NSString * label = [NSString stringWithFormat:@"com.hypelabs.gateway.shard%lu", (unsigned long)shard];
+        dispatch_queue_t queue = dispatch_queue_create([label UTF8String], DISPATCH_QUEUE_SERIAL);
+        
+        HYPUDPTransport * transport = [[HYPUDPTransport alloc] initWithPort:self.port queue:queue];
+        transport.lossRate = self.lossRate;
+        transport.session = session | 1;
+        
+        // Peers given on the command line are greeted by the first shard only;
+        // their replies are spread across shards like any other peer.
+        if (shard == 0) {
+            for (NSString * address in self.peerAddresses) {
+                [transport addPeerWithAddress:address];
+            }
+        }
+        
+        HYPLocalChatBackend * chatBackend = [[HYPLocalChatBackend alloc] initWithServer:self.server queue:queue];
+        
+        // Each shard announces itself as its own gateway.
+        NSString * identifierForVendor = [NSString stringWithFormat:@"%@-%lu", gatewayIdentifier, (unsigned long)shard];
+        HYPBridgeController * bridge = [[HYPBridgeController alloc] initWithIdentifierForVendor:identifierForVendor
+                                                                                      transport:transport
+                                                                                    chatBackend:chatBackend];
+        bridge.delegate = self;
+        bridge.messageStore = messageStore;
+        
+        // The store is shared, so one shard copying the history is enough.
+        bridge.backfillsHistory = shard == 0;
+        
+        [self.transports addObject:transport];
+        [self.bridges addObject:bridge];
+        
+        [bridge generateTwilioClient];
+        [bridge requestMeshToStart];
+    }
+    
+    NSLog(@"Gateway listening on port %u with %lu shards and %lu stored messages",
+          self.port,
+          (unsigned long)self.bridges.count,
+          (unsigned long)messageStore.count);
+    
+    [self startStatisticsTimer];
+}
+
+#pragma mark - Statistics
+
+- (void)startStatisticsTimer
+{
+    uint64_t interval = (uint64_t)(self.statisticsInterval * NSEC_PER_SEC);
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0));
+    
+    __weak HYPGatewayDaemon * weakSelf = self;
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, NSEC_PER_SEC);
+    dispatch_source_set_event_handler(timer, ^{
+        [weakSelf reportStatistics];
+    });
+    dispatch_resume(timer);
+    
+    self.statisticsTimer = timer;
+}
+
+- (void)reportStatistics
+{
+    NSUInteger messageCount = self.server.messageCount;
+    NSUInteger datagramCount = 0;
+    NSUInteger peerCount = 0;
+    
+    for (HYPUDPTransport * transport in self.transports) {
+        datagramCount += transport.sentDatagrams + transport.receivedDatagrams;
+    }
+    
+    // Peers count once they announced themselves and messages are relayed
+    // to them, not as soon as a datagram arrives.
+    for (HYPBridgeController * bridge in self.bridges) {
+        peerCount += bridge.instanceCount;
+    }
+    
+    NSTimeInterval interval = self.statisticsInterval;
+    NSUInteger cores = MAX(self.transports.count, 1);
+    
+    NSLog(@"%.1f messages/s, %.1f datagrams/s, %lu peers (%.1f per core)",
+          (messageCount - self.lastMessageCount) / interval,
+          (datagramCount - self.lastDatagramCount) / interval,
+          (unsigned long)peerCount,
+          (double)peerCount / cores);
+    
+    self.lastMessageCount = messageCount;
+    self.lastDatagramCount = datagramCount;
+    
+    [self reportSenderStatistics];
+}
+
+- (void)reportSenderStatistics
+{
+    static NSString * const classNames[HYPFramePriorityCount] = { @"control", @"interactive", @"relay", @"backfill" };
+    
+    double goodput = 0;
+    NSUInteger transmissions = 0;
+    NSUInteger retransmissions = 0;
+    NSUInteger dequeuedFrames[HYPFramePriorityCount] = { 0 };
+    NSTimeInterval totalDelay[HYPFramePriorityCount] = { 0 };
+    NSTimeInterval maximumDelay[HYPFramePriorityCount] = { 0 };
+    
+    for (HYPBridgeController * bridge in self.bridges) {
+        
+        HYPReliableSender * sender = bridge.reliableSender;
+        
+        goodput += sender.goodput;
+        transmissions += sender.transmissions;
+        retransmissions += sender.retransmissions;
+        
+        for (NSUInteger priority = 0; priority < HYPFramePriorityCount; priority++) {
+            
+            NSUInteger count = [sender.scheduler dequeuedFramesWithPriority:priority];
+            
+            dequeuedFrames[priority] += count;
+            totalDelay[priority] += count * [sender.scheduler averageQueueingDelayForPriority:priority];
+            maximumDelay[priority] = MAX(maximumDelay[priority], [sender.scheduler maximumQueueingDelayForPriority:priority]);
+        }
+    }
+    
+    NSMutableArray * classes = [NSMutableArray new];
+    
+    for (NSUInteger priority = 0; priority < HYPFramePriorityCount; priority++) {
+        
+        NSTimeInterval averageDelay = dequeuedFrames[priority] > 0 ? totalDelay[priority] / dequeuedFrames[priority] : 0;
+        
+        [classes addObject:[NSString stringWithFormat:@"%@ %lu frames %.1f/%.1f ms",
+                            classNames[priority],
+                            (unsigned long)dequeuedFrames[priority],
+                            averageDelay * 1000,
+                            maximumDelay[priority] * 1000]];
+    }
+    
+    // Delays are the mean and the maximum time spent waiting for a window.
+    NSLog(@"%.1f B/s goodput, %.2f retransmission overhead, %@",
+          goodput,
+          transmissions > 0 ? (double)retransmissions / transmissions : 0,
+          [classes componentsJoinedByString:@", "]);
+}
+
+#pragma mark - Bridge Delegates
+
+- (void)bridgeController:(HYPBridgeController *)bridgeController
+          didJoinChannel:(id)channel
+            withIdentity:(NSString *)identity
+{
+    NSLog(@"Gateway joined as %@", identity);
+}
+
+- (void)bridgeController:(HYPBridgeController *)bridgeController
+          didSendMessage:(NSString *)response
+{
+}
+
+- (void)bridgeController:(HYPBridgeController *)bridgeController
+       didReceiveMessage:(NSMutableDictionary *)message
+{
+}
+
+- (void)bridgeController:(HYPBridgeController *)bridgeController
+           didJoinTwilio:(NSMutableDictionary *)response
+{
+}
+
+- (void)bridgeController:(HYPBridgeController *)bridgeController
+          failConnecting:(NSString *)response
+{
+    NSLog(@"Gateway failed connecting [%@]", response);
+}
+
+- (void)bridgeController:(HYPBridgeController *)bridgeController
+         didLoseInstance:(NSString *)response
+{
+}
+
+- (void)bridgeController:(HYPBridgeController *)bridgeController
+     didBackfillMessages:(NSArray *)messages
+{
+}
+
+@end
@@ -0,0 +1,95 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @abstract Load generator.
+ * @discussion This class drives a gateway daemon with simulated offline
+ * peers. Each peer joins through the gateway and sends its messages at a
+ * fixed rate, or, in burst mode, every peer sends all of its messages at
+ * once after the last one joined, which the gateway then fans out to every
+ * peer. The generator logs the messages sent and relayed back, the
+ * throughput, the round trip of the messages, the peers' goodput and the
+ * retransmission overhead every statistics interval. The summary at the end
+ * of the run adds the peers' mean and maximum queueing delay for each priority class.
+ */
+@interface HYPLoadGenerator : NSObject
+
+/**
+ * @abstract Address of the gateway, as a "host:port" string.
+ */
+@property (atomic, copy) NSString * gatewayAddress;
+
+/**
+ * @abstract Number of simulated peers.
+ */
+@property (atomic) NSUInteger peerCount;
+
+/**
+ * @abstract Number of messages each peer sends.
+ */
+@property (atomic) NSUInteger messageCount;
+
+/**
+ * @abstract Messages each peer sends per second.
+ */
+@property (atomic) double rate;
+
+/**
+ * @abstract Whether the peers send all their messages at once. Defaults to NO.
+ */
+@property (atomic) BOOL burst;
+
+/**
+ * @abstract Probability of dropping an outgoing datagram.
+ */
+@property (atomic) double lossRate;
+
+/**
+ * @abstract Seed of the simulated loss and of the send offsets.
+ * @discussion Zero, the default, picks a random seed.
+ */
+@property (atomic) uint64_t seed;
+
+/**
+ * @abstract Interval between statistics reports, in seconds.
+ */
+@property (atomic) NSTimeInterval statisticsInterval;
+
+/**
+ * @abstract Time after which the run ends even if messages are missing.
+ */
+@property (atomic) NSTimeInterval duration;
+
+/**
+ * @abstract Starts the peers.
+ * @discussion This method returns immediately. The completion is called
+ * on a global queue once every message came back or the duration elapsed.
+ * @param completion Block called when the run ends.
+ */
+- (void)startWithCompletion:(void (^)(void))completion;
+
+@end
@@ -0,0 +1,263 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPLoadGenerator.h"
+#import "HYPSimulatedPeer.h"
+
+@interface HYPLoadGenerator ()
+
+@property (strong, atomic, readonly) NSMutableArray * peers;
+@property (atomic) dispatch_source_t statisticsTimer;
+@property (atomic) dispatch_source_t burstTimer;
+@property (atomic, copy) void (^completion)(void);
+@property (atomic) NSDate * startDate;
+@property (atomic) NSUInteger lastReturnedMessages;
+
+@end
+
+@implementation HYPLoadGenerator
+@synthesize peers = _peers;
+
+- (instancetype)init
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _peers = [NSMutableArray new];
+        _gatewayAddress = @"127.0.0.1:7878";
+        _peerCount = 10;
+        _messageCount = 100;
+        _rate = 1.0;
+        _statisticsInterval = 5.0;
+        _duration = 300.0;
+    }
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_statisticsTimer != nil) {
+        dispatch_source_cancel(_statisticsTimer);
+    }
+    
+    if (_burstTimer != nil) {
+        dispatch_source_cancel(_burstTimer);
+    }
+}
+
+- (void)startWithCompletion:(void (^)(void))completion
+{
+    self.completion = completion;
+    self.startDate = [NSDate date];
+    
+    if (self.seed != 0) {
+        srand48((long)self.seed);
+    }
+    
+    for (NSUInteger peer = 0; peer < self.peerCount; peer++) {
+        
+        HYPSimulatedPeer * simulatedPeer = [[HYPSimulatedPeer alloc] initWithGatewayAddress:self.gatewayAddress
+                                                                               messageCount:self.messageCount
+                                                                                       rate:self.rate
+                                                                                   lossRate:self.lossRate];
+        simulatedPeer.burst = self.burst;
+        [self.peers addObject:simulatedPeer];
+        [simulatedPeer start];
+    }
+    
+    if (self.burst) {
+        
+        NSLog(@"Load generator started %lu peers against %@, %lu messages each in one burst",
+              (unsigned long)self.peerCount,
+              self.gatewayAddress,
+              (unsigned long)self.messageCount);
+        
+        [self startBurstTimer];
+        
+    } else {
+        
+        NSLog(@"Load generator started %lu peers against %@, %lu messages each at %.1f/s",
+              (unsigned long)self.peerCount,
+              self.gatewayAddress,
+              (unsigned long)self.messageCount,
+              self.rate);
+    }
+    
+    uint64_t interval = (uint64_t)(self.statisticsInterval * NSEC_PER_SEC);
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0));
+    
+    __weak HYPLoadGenerator * weakSelf = self;
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, NSEC_PER_SEC / 10);
+    dispatch_source_set_event_handler(timer, ^{
+        [weakSelf reportStatistics];
+    });
+    dispatch_resume(timer);
+    
+    self.statisticsTimer = timer;
+}
+
+#pragma mark - Burst
+
+- (void)startBurstTimer
+{
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+    
+    __weak HYPLoadGenerator * weakSelf = self;
+    dispatch_source_set_timer(timer, DISPATCH_TIME_NOW, NSEC_PER_MSEC * 50, NSEC_PER_MSEC * 5);
+    dispatch_source_set_event_handler(timer, ^{
+        [weakSelf startBurstIfJoined];
+    });
+    dispatch_resume(timer);
+    
+    self.burstTimer = timer;
+}
+
+- (void)startBurstIfJoined
+{
+    for (HYPSimulatedPeer * peer in self.peers) {
+        
+        if (!peer.joined) {
+            return;
+        }
+    }
+    
+    dispatch_source_cancel(self.burstTimer);
+    
+    NSLog(@"All %lu peers joined, bursting %lu messages",
+          (unsigned long)self.peers.count,
+          (unsigned long)(self.peers.count * self.messageCount));
+    
+    // Every peer is started before any of them is done, so the gateway
+    // gets all the messages at once and fans each one out to every peer.
+    for (HYPSimulatedPeer * peer in self.peers) {
+        [peer sendBurst];
+    }
+}
+
+#pragma mark - Statistics
+
+- (NSString *)queueingDelaySummary
+{
+    static NSString * const classNames[HYPFramePriorityCount] = { @"control", @"interactive", @"relay", @"backfill" };
+    
+    NSUInteger dequeuedFrames[HYPFramePriorityCount] = { 0 };
+    NSTimeInterval totalDelay[HYPFramePriorityCount] = { 0 };
+    NSTimeInterval maximumDelay[HYPFramePriorityCount] = { 0 };
+    NSMutableArray * classes = [NSMutableArray new];
+    
+    for (HYPSimulatedPeer * peer in self.peers) {
+        
+        HYPFrameScheduler * scheduler = peer.reliableSender.scheduler;
+        
+        for (NSUInteger priority = 0; priority < HYPFramePriorityCount; priority++) {
+            
+            NSUInteger count = [scheduler dequeuedFramesWithPriority:priority];
+            
+            dequeuedFrames[priority] += count;
+            totalDelay[priority] += count * [scheduler averageQueueingDelayForPriority:priority];
+            maximumDelay[priority] = MAX(maximumDelay[priority], [scheduler maximumQueueingDelayForPriority:priority]);
+        }
+    }
+    
+    for (NSUInteger priority = 0; priority < HYPFramePriorityCount; priority++) {
+        
+        NSTimeInterval averageDelay = dequeuedFrames[priority] > 0 ? totalDelay[priority] / dequeuedFrames[priority] : 0;
+        
+        [classes addObject:[NSString stringWithFormat:@"%@ %lu frames %.1f/%.1f ms",
+                            classNames[priority],
+                            (unsigned long)dequeuedFrames[priority],
+                            averageDelay * 1000,
+                            maximumDelay[priority] * 1000]];
+    }
+    
+    return [classes componentsJoinedByString:@", "];
+}
+
+- (void)reportStatistics
+{
+    NSUInteger joinedPeers = 0;
+    NSUInteger sentMessages = 0;
+    NSUInteger receivedMessages = 0;
+    NSUInteger returnedMessages = 0;
+    NSUInteger transmissions = 0;
+    NSUInteger retransmissions = 0;
+    double goodput = 0;
+    NSTimeInterval totalLatency = 0;
+    NSTimeInterval maximumLatency = 0;
+    
+    for (HYPSimulatedPeer * peer in self.peers) {
+        
+        joinedPeers += peer.joined ? 1 : 0;
+        sentMessages += peer.sentMessages;
+        receivedMessages += peer.receivedMessages;
+        returnedMessages += peer.returnedMessages;
+        transmissions += peer.transmissions;
+        retransmissions += peer.retransmissions;
+        goodput += peer.reliableSender.goodput;
+        totalLatency += peer.totalLatency;
+        maximumLatency = MAX(maximumLatency, peer.maximumLatency);
+    }
+    
+    NSTimeInterval elapsed = -[self.startDate timeIntervalSinceNow];
+    BOOL finished = returnedMessages >= self.peerCount * self.messageCount || elapsed >= self.duration;
+    
+    // While running, throughput is over the last interval; the summary
+    // gives it over the whole run.
+    double throughput = finished
+        ? returnedMessages / MAX(elapsed, 0.001)
+        : (returnedMessages - self.lastReturnedMessages) / self.statisticsInterval;
+    
+    NSLog(@"%@%lu/%lu peers joined, %lu sent, %lu returned, %lu relayed, %.1f messages/s, round trip %.1f/%.1f ms, %.1f B/s goodput, %.2f retransmission overhead",
+          finished ? @"Finished: " : @"",
+          (unsigned long)joinedPeers,
+          (unsigned long)self.peers.count,
+          (unsigned long)sentMessages,
+          (unsigned long)returnedMessages,
+          (unsigned long)receivedMessages,
+          throughput,
+          returnedMessages > 0 ? totalLatency / returnedMessages * 1000 : 0,
+          maximumLatency * 1000,
+          goodput,
+          transmissions > 0 ? (double)retransmissions / transmissions : 0);
+    
+    self.lastReturnedMessages = returnedMessages;
+    
+    if (finished) {
+        
+        // Peers only queue their own frames; the delays of the relay fan-out
+        // are in the gateway's log.
+        NSLog(@"Peer queueing delays: %@", [self queueingDelaySummary]);
+        
+        dispatch_source_cancel(self.statisticsTimer);
+        
+        if (self.completion != nil) {
+            self.completion();
+        }
+    }
+}
+
+@end
@@ -0,0 +1,51 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPChatBackend.h"
+#import "HYPLocalChatServer.h"
+
+/**
+ * @abstract Local chat backend.
+ * @discussion This class implements the chat backend on top of the local
+ * chat server. Like a Twilio client, every client generated by the backend
+ * receives its own copy of each message. Channels handed to the delegate
+ * are the identities of the clients that joined them. Notifications are
+ * issued on the queue given at initialization.
+ */
+@interface HYPLocalChatBackend : NSObject <HYPChatBackend, HYPLocalChatServerObserver>
+
+@property (atomic, weak) id<HYPChatBackendDelegate> delegate;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a backend that posts to the given server.
+ * @param server Server to post to.
+ * @param queue Queue on which notifications are issued.
+ */
+- (instancetype)initWithServer:(HYPLocalChatServer *)server
+                         queue:(dispatch_queue_t)queue;
+
+@end
@@ -0,0 +1,131 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPLocalChatBackend.h"
+
+@interface HYPLocalChatBackend ()
+
+@property (atomic, readonly) HYPLocalChatServer * server;
+@property (atomic, readonly) dispatch_queue_t queue;
+@property (strong, atomic, readonly) NSMutableDictionary * clients;
+
+@end
+
+@implementation HYPLocalChatBackend
+@synthesize server = _server;
+@synthesize queue = _queue;
+@synthesize clients = _clients;
+
+- (instancetype)initWithServer:(HYPLocalChatServer *)server
+                         queue:(dispatch_queue_t)queue
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _server = server;
+        _queue = queue;
+        _clients = [NSMutableDictionary new];
+        
+        [server addObserver:self];
+    }
+    
+    return self;
+}
+
+- (void)generateClientWithIdentifierForVendor:(NSString *)identifierForVendor
+{
+    dispatch_async(self.queue, ^{
+        
+        // The token server derives identities from the device; a short
+        // prefix of the identifier is enough to tell clients apart in logs.
+        NSString * identity = [NSString stringWithFormat:@"offline-%@", [identifierForVendor substringToIndex:MIN(identifierForVendor.length, 8)]];
+        [self.clients setObject:identity forKey:identifierForVendor];
+        
+        if ([self.delegate respondsToSelector:@selector(chatBackend:didJoinChannel:withIdentifierForVendor:identity:)]) {
+            [self.delegate chatBackend:self
+                        didJoinChannel:identity
+               withIdentifierForVendor:identifierForVendor
+                              identity:identity];
+        }
+    });
+}
+
+- (void)sendMessageToChannel:(id)channel
+                    withText:(NSString *)text
+{
+    if (channel == nil || text == nil) {
+        
+        if ([self.delegate respondsToSelector:@selector(chatBackend:didSendMessage:)]) {
+            [self.delegate chatBackend:self didSendMessage:@"Error"];
+        }
+        return;
+    }
+    
+    [self.server postMessageWithBody:text author:channel];
+    
+    dispatch_async(self.queue, ^{
+        
+        if ([self.delegate respondsToSelector:@selector(chatBackend:didSendMessage:)]) {
+            [self.delegate chatBackend:self didSendMessage:@"Success"];
+        }
+    });
+}
+
+- (void)localChatServer:(HYPLocalChatServer *)server
+          didAddMessage:(NSDictionary *)message
+{
+    dispatch_async(self.queue, ^{
+        
+        NSUInteger clientCount = self.clients.count;
+        
+        for (NSUInteger client = 0; client < clientCount; client++) {
+            
+            if ([self.delegate respondsToSelector:@selector(chatBackend:didReceiveMessage:)]) {
+                [self.delegate chatBackend:self didReceiveMessage:message];
+            }
+        }
+    });
+}
+
+// Every client joins the server's single channel.
+- (NSString *)identifierForChannel:(id)channel
+{
+    return self.server.channelIdentifier;
+}
+
+- (void)fetchMessagesFromChannel:(id)channel
+                     beforeIndex:(NSNumber *)index
+                       withCount:(NSUInteger)count
+                      completion:(void (^)(NSArray * messages))completion
+{
+    dispatch_async(self.queue, ^{
+        
+        NSUInteger upper = index != nil ? index.unsignedIntegerValue : NSUIntegerMax;
+        completion([self.server messagesBeforeIndex:upper count:count]);
+    });
+}
+
+@end
@@ -0,0 +1,110 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class HYPLocalChatServer;
+
+/**
+ * @abstract Local chat server observer.
+ * @discussion Observers are notified of every message posted to the server,
+ * on the thread that posted it.
+ */
+@protocol HYPLocalChatServerObserver <NSObject>
+
+/**
+ * @abstract Notification issued when a message is posted.
+ * @param server The server issuing the notification.
+ * @param message Message posted, with the "sid", "author", "body", "index"
+ * and "timestamp" keys.
+ */
+- (void)localChatServer:(HYPLocalChatServer *)server
+          didAddMessage:(NSDictionary *)message;
+
+@end
+
+/**
+ * @abstract Local chat server.
+ * @discussion This class stands in for the Twilio service when the bridge
+ * runs in the gateway daemon. It keeps a single public channel in memory
+ * and fans every message out to its observers. It is safe to use from
+ * several threads.
+ */
+@interface HYPLocalChatServer : NSObject
+
+@property (atomic, readonly) NSUInteger messageCount;
+
+/**
+ * @abstract Sid of the channel, derived from the server's seed.
+ */
+@property (atomic, readonly) NSString * channelIdentifier;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a server whose sids are derived from the given
+ * seed, so that runs started with the same seed produce the same sids.
+ * The default initializer picks a random seed.
+ * @param seed Seed of the server.
+ */
+- (instancetype)initWithSeed:(uint64_t)seed;
+
+/**
+ * @abstract Posts generated messages.
+ * @discussion This method fills the channel with history, for instance to
+ * load test backfill and reconciliation. The bodies are generated from the
+ * server's seed, so they are the same on every run with that seed.
+ * @param count Number of messages to post.
+ */
+- (void)postHistoryWithCount:(NSUInteger)count;
+
+/**
+ * @abstract Registers an observer.
+ * @discussion Observers are held weakly.
+ * @param observer Observer to register.
+ */
+- (void)addObserver:(id<HYPLocalChatServerObserver>)observer;
+
+/**
+ * @abstract Posts a message to the channel.
+ * @discussion This method assigns the message an identifier and an index
+ * and notifys the observers.
+ * @param body Message text.
+ * @param author Identity of the author.
+ * @return Message posted.
+ */
+- (NSDictionary *)postMessageWithBody:(NSString *)body
+                               author:(NSString *)author;
+
+/**
+ * @abstract Messages below an index.
+ * @discussion This method returns the newest messages whose index is below
+ * the given one, in ascending index order.
+ * @param index Exclusive upper bound.
+ * @param count Maximum number of messages.
+ */
+- (NSArray *)messagesBeforeIndex:(NSUInteger)index
+                           count:(NSUInteger)count;
+
+@end
@@ -0,0 +1,164 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPLocalChatServer.h"
+
+@interface HYPLocalChatServer ()
+
+@property (strong, atomic, readonly) NSMutableArray * messages;
+@property (strong, atomic, readonly) NSHashTable * observers;
+@property (atomic) uint64_t serverIdentifier;
+@property (atomic) uint64_t randomState;
+
+@end
+
+@implementation HYPLocalChatServer
+@synthesize messages = _messages;
+@synthesize observers = _observers;
+
+- (instancetype)init
+{
+    uint64_t seed;
+    uuid_t bytes;
+    [[NSUUID UUID] getUUIDBytes:bytes];
+    memcpy(&seed, bytes, sizeof(seed));
+    
+    return [self initWithSeed:seed];
+}
+
+- (instancetype)initWithSeed:(uint64_t)seed
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _messages = [NSMutableArray new];
+        _observers = [NSHashTable weakObjectsHashTable];
+        _randomState = seed;
+        _serverIdentifier = [self nextRandom];
+    }
+    
+    return self;
+}
+
+// SplitMix64, which spreads consecutive seeds over the whole range.
+- (uint64_t)nextRandom
+{
+    @synchronized(self) {
+        
+        uint64_t z = (_randomState += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        
+        return z ^ (z >> 31);
+    }
+}
+
+- (void)postHistoryWithCount:(NSUInteger)count
+{
+    static NSString * const words[] = { @"hello", @"mesh", @"gateway", @"offline", @"venue",
+                                        @"stage", @"battery", @"meet", @"tonight", @"signal" };
+    const NSUInteger wordCount = sizeof(words) / sizeof(words[0]);
+    
+    for (NSUInteger message = 0; message < count; message++) {
+        
+        uint64_t random = [self nextRandom];
+        NSMutableArray * body = [NSMutableArray new];
+        
+        for (NSUInteger word = 0; word < 3 + random % 8; word++) {
+            [body addObject:words[(random >> (8 + 4 * word)) % wordCount]];
+        }
+        
+        [self postMessageWithBody:[body componentsJoinedByString:@" "]
+                           author:[NSString stringWithFormat:@"seed-%02u", (unsigned)((random >> 56) % 16)]];
+    }
+}
+
+- (NSUInteger)messageCount
+{
+    @synchronized(self) {
+        return self.messages.count;
+    }
+}
+
+- (NSString *)channelIdentifier
+{
+    return [NSString stringWithFormat:@"CH%032llx", (unsigned long long)self.serverIdentifier];
+}
+
+- (void)addObserver:(id<HYPLocalChatServerObserver>)observer
+{
+    @synchronized(self) {
+        [self.observers addObject:observer];
+    }
+}
+
+- (NSDictionary *)postMessageWithBody:(NSString *)body
+                               author:(NSString *)author
+{
+    NSArray * observers;
+    NSDictionary * message;
+    
+    @synchronized(self) {
+        
+        NSUInteger index = self.messages.count;
+        
+        // Sids follow the Twilio format: a two letter prefix and 32 hex digits.
+        // The server half keeps sids unique across gateways that reconcile
+        // their stores, and the index half keeps them in posting order.
+        NSString * sid = [NSString stringWithFormat:@"IM%016llx%016llx",
+                          (unsigned long long)self.serverIdentifier,
+                          (unsigned long long)index];
+        
+        message = @{ @"sid" : sid,
+                     @"author" : author,
+                     @"body" : body,
+                     @"index" : @(index),
+                     @"timestamp" : @([[NSDate date] timeIntervalSince1970]) };
+        
+        [self.messages addObject:message];
+        observers = [self.observers allObjects];
+    }
+    
+    for (id<HYPLocalChatServerObserver> observer in observers) {
+        [observer localChatServer:self didAddMessage:message];
+    }
+    
+    return message;
+}
+
+- (NSArray *)messagesBeforeIndex:(NSUInteger)index
+                           count:(NSUInteger)count
+{
+    @synchronized(self) {
+        
+        NSUInteger upper = MIN(index, self.messages.count);
+        NSUInteger lower = upper > count ? upper - count : 0;
+        
+        return [self.messages subarrayWithRange:NSMakeRange(lower, upper - lower)];
+    }
+}
+
+@end
@@ -0,0 +1,69 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @abstract Search benchmark.
+ * @discussion This class measures the search index on a generated history.
+ * It fills a message store in a temporary directory, indexes it from
+ * scratch and saves the index, then runs prefix queries one at a time. It
+ * reports the messages indexed per second, counting the save, the index
+ * bytes on disk per
+ * message, and the median and 99th percentile query latency. The directory
+ * is removed once the run ends.
+ */
+@interface HYPSearchBenchmark : NSObject
+
+/**
+ * @abstract Number of messages in the store. Defaults to 1000000.
+ */
+@property (atomic) NSUInteger messageCount;
+
+/**
+ * @abstract Number of queries run. Defaults to 1000.
+ */
+@property (atomic) NSUInteger queryCount;
+
+/**
+ * @abstract Maximum number of messages returned by each query.
+ */
+@property (atomic) NSUInteger limit;
+
+/**
+ * @abstract Seed of the generated messages and queries.
+ * @discussion Zero, the default, picks a random seed.
+ */
+@property (atomic) uint64_t seed;
+
+/**
+ * @abstract Starts the benchmark.
+ * @discussion This method returns immediately. The completion is called on
+ * the main queue once every query ran.
+ * @param completion Block called when the benchmark ends.
+ */
+- (void)startWithCompletion:(void (^)(void))completion;
+
+@end
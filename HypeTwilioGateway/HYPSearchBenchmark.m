@@ -0,0 +1,235 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPSearchBenchmark.h"
+#import "HYPMessageStore.h"
+#import "HYPSearchIndex.h"
+
+// Words of the generated bodies. Earlier words are picked more often, so
+// posting lists range from very long to short as in real chat.
+static NSString * const HYPSearchBenchmarkWords[] = {
+    @"hello", @"the", @"stage", @"meet", @"at", @"gate", @"tonight", @"where",
+    @"are", @"you", @"battery", @"low", @"signal", @"mesh", @"gateway", @"offline",
+    @"venue", @"food", @"water", @"north", @"south", @"entrance", @"exit", @"tent",
+    @"friends", @"lost", @"found", @"phone", @"charger", @"music", @"band", @"encore",
+    @"ticket", @"bus", @"parking", @"shuttle", @"medic", @"security", @"merch", @"queue",
+    @"camping", @"rain", @"sunny", @"coffee", @"breakfast", @"lineup", @"schedule", @"headliner",
+    @"acoustic", @"backstage", @"wristband", @"lockers", @"toilets", @"showers", @"festival", @"midnight",
+    @"sunrise", @"dance", @"crowd", @"barrier", @"speaker", @"bass", @"drums", @"guitar"
+};
+
+static const NSUInteger HYPSearchBenchmarkWordCount = sizeof(HYPSearchBenchmarkWords) / sizeof(HYPSearchBenchmarkWords[0]);
+
+@interface HYPSearchBenchmark ()
+
+@property (atomic) NSString * directory;
+@property (atomic) HYPMessageStore * messageStore;
+@property (atomic) HYPSearchIndex * searchIndex;
+@property (strong, atomic, readonly) NSMutableArray * queryIntervals;
+@property (atomic, copy) void (^completion)(void);
+@property (atomic) NSDate * indexDate;
+@property (atomic) NSTimeInterval indexInterval;
+
+@end
+
+@implementation HYPSearchBenchmark
+@synthesize queryIntervals = _queryIntervals;
+
+- (instancetype)init
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _messageCount = 1000000;
+        _queryCount = 1000;
+        _limit = 100;
+        _queryIntervals = [NSMutableArray new];
+    }
+    
+    return self;
+}
+
+#pragma mark - Setup
+
++ (NSString *)generatedWord
+{
+    // Squaring a uniform draw skews the picks towards the first words.
+    double draw = drand48();
+    
+    return HYPSearchBenchmarkWords[(NSUInteger)(draw * draw * HYPSearchBenchmarkWordCount)];
+}
+
+- (NSDictionary *)generatedMessageWithIndex:(NSUInteger)index
+{
+    NSString * sid = [NSString stringWithFormat:@"IM%08lx%08lx%08lx%08lx",
+                      (unsigned long)(mrand48() & 0xffffffff),
+                      (unsigned long)(mrand48() & 0xffffffff),
+                      (unsigned long)(mrand48() & 0xffffffff),
+                      (unsigned long)(mrand48() & 0xffffffff)];
+    NSMutableArray * body = [NSMutableArray new];
+    
+    for (NSUInteger word = 0; word < 3 + lrand48() % 10; word++) {
+        [body addObject:[HYPSearchBenchmark generatedWord]];
+    }
+    
+    return @{ @"sid" : sid,
+              @"author" : [NSString stringWithFormat:@"user-%03lu", (unsigned long)(lrand48() % 256)],
+              @"body" : [body componentsJoinedByString:@" "],
+              @"index" : @(index),
+              @"timestamp" : @(1500000000 + index) };
+}
+
+- (NSString *)generatedQuery
+{
+    NSMutableArray * prefixes = [NSMutableArray new];
+    
+    // One or two words, each cut to a prefix of at least two letters.
+    for (NSUInteger word = 0; word < 1 + lrand48() % 2; word++) {
+        
+        NSString * text = HYPSearchBenchmarkWords[lrand48() % HYPSearchBenchmarkWordCount];
+        NSUInteger length = 2 + lrand48() % (text.length - 1);
+        
+        [prefixes addObject:[text substringToIndex:MIN(length, text.length)]];
+    }
+    
+    return [prefixes componentsJoinedByString:@" "];
+}
+
+- (void)startWithCompletion:(void (^)(void))completion
+{
+    self.completion = completion;
+    
+    if (self.seed != 0) {
+        srand48((long)self.seed);
+    } else {
+        srand48((long)time(NULL));
+    }
+    
+    self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"hype-search-%@", [[NSUUID UUID] UUIDString]]];
+    
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [self fillStore];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self buildIndex];
+        });
+    });
+}
+
+- (void)fillStore
+{
+    NSDate * date = [NSDate date];
+    
+    self.messageStore = [[HYPMessageStore alloc] initWithPath:[self.directory stringByAppendingPathComponent:@"messages.log"]];
+    
+    for (NSUInteger index = 0; index < self.messageCount; index++) {
+        
+        @autoreleasepool {
+            [self.messageStore addMessage:[self generatedMessageWithIndex:index]];
+        }
+    }
+    
+    NSLog(@"Stored %lu messages in %.1fs",
+          (unsigned long)self.messageStore.count,
+          -[date timeIntervalSinceNow]);
+}
+
+#pragma mark - Measurement
+
+- (void)buildIndex
+{
+    __weak HYPSearchBenchmark * weakSelf = self;
+    
+    // The index starts indexing the whole store as soon as it is created.
+    self.indexDate = [NSDate date];
+    self.searchIndex = [[HYPSearchIndex alloc] initWithMessageStore:self.messageStore
+                                                               path:[self.directory stringByAppendingPathComponent:@"messages.index"]];
+    
+    // An empty query returns once everything stored was indexed.
+    [self.searchIndex searchWithQuery:@"" limit:0 completion:^(NSArray * messages) {
+        
+        weakSelf.indexInterval = -[weakSelf.indexDate timeIntervalSinceNow];
+        
+        [weakSelf.searchIndex saveWithCompletion:^{
+            [weakSelf runQueryWithNumber:0];
+        }];
+    }];
+}
+
+- (void)runQueryWithNumber:(NSUInteger)number
+{
+    if (number >= self.queryCount) {
+        [self finish];
+        return;
+    }
+    
+    __weak HYPSearchBenchmark * weakSelf = self;
+    
+    // Queries run one at a time, so each latency is that of a lone query.
+    [self.searchIndex searchWithQuery:[self generatedQuery] limit:self.limit completion:^(NSArray * messages) {
+        
+        [weakSelf.queryIntervals addObject:@(weakSelf.searchIndex.lastQueryInterval)];
+        [weakSelf runQueryWithNumber:number + 1];
+    }];
+}
+
+- (unsigned long long)indexLength
+{
+    NSFileManager * fileManager = [NSFileManager defaultManager];
+    NSString * path = [self.directory stringByAppendingPathComponent:@"messages.index"];
+    unsigned long long length = 0;
+    
+    for (NSString * file in @[path, [path stringByAppendingPathExtension:@"segment"]]) {
+        length += [[fileManager attributesOfItemAtPath:file error:nil] fileSize];
+    }
+    
+    return length;
+}
+
+- (void)finish
+{
+    NSArray * intervals = [self.queryIntervals sortedArrayUsingSelector:@selector(compare:)];
+    NSUInteger count = MAX(self.messageStore.count, 1);
+    NSTimeInterval median = intervals.count > 0 ? [intervals[intervals.count / 2] doubleValue] : 0;
+    NSTimeInterval tail = intervals.count > 0 ? [intervals[MIN(intervals.count - 1, intervals.count * 99 / 100)] doubleValue] : 0;
+    
+    NSLog(@"Indexed %lu messages in %.1fs [%.0f messages/s, %.1f index bytes per message], %lu queries [p50 %.2f ms, p99 %.2f ms]",
+          (unsigned long)self.searchIndex.documentCount,
+          self.indexInterval,
+          self.searchIndex.documentCount / MAX(self.indexInterval, 0.001),
+          (double)[self indexLength] / count,
+          (unsigned long)intervals.count,
+          median * 1000,
+          tail * 1000);
+    
+    [[NSFileManager defaultManager] removeItemAtPath:self.directory error:nil];
+    
+    if (self.completion != nil) {
+        self.completion();
+    }
+}
+
+@end
@@ -0,0 +1,101 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPMeshControllerDelegate.h"
+#import "HYPReliableSender.h"
+
+/**
+ * @abstract Simulated peer.
+ * @discussion This class plays an offline phone against a gateway, for load
+ * testing. It owns a UDP transport on an ephemeral port and a mesh
+ * controller, so it speaks the same frames as the app: it announces itself,
+ * waits for the gateway to join it to the channel and then sends its
+ * messages at a fixed rate, or all at once when told to burst. Messages
+ * relayed back by the gateway are counted, and the round trip of its own
+ * messages is measured.
+ */
+@interface HYPSimulatedPeer : NSObject <HYPMeshControllerDelegate>
+
+/**
+ * @abstract Whether the gateway joined this peer to the channel.
+ */
+@property (atomic, readonly) BOOL joined;
+
+/**
+ * @abstract Whether the peer waits for sendBurst instead of sending at its
+ * rate once joined. Defaults to NO.
+ */
+@property (atomic) BOOL burst;
+
+/**
+ * @abstract Sender of the peer's frames, for its queueing statistics.
+ */
+@property (atomic, readonly) HYPReliableSender * reliableSender;
+
+@property (atomic, readonly) NSUInteger sentMessages;
+@property (atomic, readonly) NSUInteger receivedMessages;
+@property (atomic, readonly) NSUInteger returnedMessages;
+@property (atomic, readonly) NSUInteger deliveredFrames;
+@property (atomic, readonly) NSUInteger transmissions;
+@property (atomic, readonly) NSUInteger retransmissions;
+
+/**
+ * @abstract Sum of the round trips of the messages that came back.
+ */
+@property (atomic, readonly) NSTimeInterval totalLatency;
+
+/**
+ * @abstract Longest round trip of a message that came back.
+ */
+@property (atomic, readonly) NSTimeInterval maximumLatency;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a peer that will send the given number of
+ * messages to the gateway.
+ * @param gatewayAddress Address of the gateway, as a "host:port" string.
+ * @param messageCount Number of messages to send.
+ * @param rate Messages sent per second.
+ * @param lossRate Probability of dropping an outgoing datagram.
+ */
+- (instancetype)initWithGatewayAddress:(NSString *)gatewayAddress
+                          messageCount:(NSUInteger)messageCount
+                                  rate:(double)rate
+                              lossRate:(double)lossRate;
+
+/**
+ * @abstract Starts greeting the gateway.
+ */
+- (void)start;
+
+/**
+ * @abstract Sends every remaining message at once.
+ * @discussion Messages are handed to the sender back to back, so they
+ * queue for its send windows instead of being spread over time.
+ */
+- (void)sendBurst;
+
+@end
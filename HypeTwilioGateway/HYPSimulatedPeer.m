@@ -0,0 +1,265 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPSimulatedPeer.h"
+#import "HYPMeshController.h"
+#import "HYPUDPTransport.h"
+
+@interface HYPSimulatedPeer ()
+
+@property (atomic, readonly) NSString * identifierForVendor;
+@property (atomic, readonly) NSUInteger messageCount;
+@property (atomic, readonly) double rate;
+@property (atomic, readonly) dispatch_queue_t queue;
+@property (atomic, readonly) HYPUDPTransport * transport;
+@property (atomic, readonly) HYPMeshController * meshController;
+@property (atomic) id gateway;
+@property (atomic) dispatch_source_t sendTimer;
+@property (atomic, readwrite) BOOL joined;
+@property (atomic, readwrite) NSUInteger sentMessages;
+@property (atomic, readwrite) NSUInteger receivedMessages;
+@property (atomic, readwrite) NSUInteger returnedMessages;
+@property (atomic, readwrite) NSTimeInterval totalLatency;
+@property (atomic, readwrite) NSTimeInterval maximumLatency;
+
+@end
+
+@implementation HYPSimulatedPeer
+@synthesize identifierForVendor = _identifierForVendor;
+@synthesize messageCount = _messageCount;
+@synthesize rate = _rate;
+@synthesize queue = _queue;
+@synthesize transport = _transport;
+@synthesize meshController = _meshController;
+
+- (instancetype)initWithGatewayAddress:(NSString *)gatewayAddress
+                          messageCount:(NSUInteger)messageCount
+                                  rate:(double)rate
+                              lossRate:(double)lossRate
+{
+    self = [super init];
+    
+    if (self) {
+        
+        // The gateway names clients after the start of the identifier, so
+        // it has to differ between peers right from the first characters.
+        _identifierForVendor = [[NSUUID UUID] UUIDString];
+        _messageCount = messageCount;
+        _rate = MAX(rate, 0.001);
+        
+        NSString * label = [NSString stringWithFormat:@"com.hypelabs.loadgen.%@", _identifierForVendor];
+        _queue = dispatch_queue_create([label UTF8String], DISPATCH_QUEUE_SERIAL);
+        
+        // Port zero binds an ephemeral port, so every peer has its own address.
+        _transport = [[HYPUDPTransport alloc] initWithPort:0 queue:_queue];
+        _transport.lossRate = lossRate;
+        [_transport addPeerWithAddress:gatewayAddress];
+        
+        _meshController = [[HYPMeshController alloc] initWithTransport:_transport
+                                                   identifierForVendor:_identifierForVendor];
+        _meshController.delegate = self;
+    }
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_sendTimer != nil) {
+        dispatch_source_cancel(_sendTimer);
+    }
+}
+
+- (void)start
+{
+    [self.meshController start];
+}
+
+- (HYPReliableSender *)reliableSender
+{
+    return self.meshController.reliableSender;
+}
+
+- (NSUInteger)deliveredFrames
+{
+    return self.meshController.reliableSender.deliveredFrames;
+}
+
+- (NSUInteger)transmissions
+{
+    return self.meshController.reliableSender.transmissions;
+}
+
+- (NSUInteger)retransmissions
+{
+    return self.meshController.reliableSender.retransmissions;
+}
+
+#pragma mark - Sending
+
+- (void)startSending
+{
+    if (self.sendTimer != nil) {
+        return;
+    }
+    
+    uint64_t interval = (uint64_t)(NSEC_PER_SEC / self.rate);
+    
+    // Peers joined at the same time start at random offsets, so that the
+    // gateway sees a steady load rather than bursts.
+    uint64_t offset = (uint64_t)(drand48() * interval);
+    
+    __weak HYPSimulatedPeer * weakSelf = self;
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.queue);
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, offset), interval, interval / 10);
+    dispatch_source_set_event_handler(timer, ^{
+        [weakSelf sendNextMessage];
+    });
+    dispatch_resume(timer);
+    
+    self.sendTimer = timer;
+}
+
+- (void)sendBurst
+{
+    dispatch_async(self.queue, ^{
+        
+        while (self.gateway != nil && self.sentMessages < self.messageCount) {
+            [self sendNextMessage];
+        }
+    });
+}
+
+- (void)sendNextMessage
+{
+    if (self.sentMessages >= self.messageCount) {
+        
+        if (self.sendTimer != nil) {
+            dispatch_source_cancel(self.sendTimer);
+        }
+        return;
+    }
+    
+    if (self.gateway == nil) {
+        return;
+    }
+    
+    // The body carries what is needed to measure the round trip when the
+    // gateway relays the message back.
+    NSString * text = [NSString stringWithFormat:@"loadgen %@ %lu %f",
+                       self.identifierForVendor,
+                       (unsigned long)self.sentMessages,
+                       [NSDate timeIntervalSinceReferenceDate]];
+    
+    [self.meshController sendMessageToCloserInstance:self.gateway
+                                            withText:text
+                                 identifierForVendor:self.identifierForVendor];
+    
+    self.sentMessages += 1;
+}
+
+#pragma mark - Mesh Delegates
+
+- (void)meshController:(HYPMeshController *)meshController
+   requestTwilioClient:(NSString *)identifierForVendor
+{
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+         didJoinTwilio:(NSMutableDictionary *)response
+{
+    self.joined = YES;
+    
+    if (!self.burst) {
+        [self startSending];
+    }
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+        didSendMessage:(NSString *)message
+  fromIdentifierVendor:(NSString *)identifierVendor
+{
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+      didFoundInstance:(id)instance
+withIdentifierForVendor:(NSString *)identifierForVendor
+{
+    // The only peer this transport greets is the gateway.
+    if (self.gateway == nil) {
+        self.gateway = instance;
+    }
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+        didFindGateway:(id)instance
+{
+    self.gateway = instance;
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+       didLoseInstance:(id)instance
+{
+    if ([instance isEqual:self.gateway]) {
+        self.gateway = nil;
+    }
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+     didReceiveMessage:(NSMutableDictionary *)message
+{
+    self.receivedMessages += 1;
+    
+    NSString * body = [message objectForKey:@"body"];
+    
+    if (![body isKindOfClass:[NSString class]]) {
+        return;
+    }
+    
+    NSArray * fields = [body componentsSeparatedByString:@" "];
+    
+    if (fields.count != 4 || ![[fields objectAtIndex:1] isEqualToString:self.identifierForVendor]) {
+        return;
+    }
+    
+    NSTimeInterval latency = [NSDate timeIntervalSinceReferenceDate] - [[fields objectAtIndex:3] doubleValue];
+    
+    self.returnedMessages += 1;
+    self.totalLatency += latency;
+    self.maximumLatency = MAX(self.maximumLatency, latency);
+}
+
+- (void)meshController:(HYPMeshController *)meshController
+     didRecoverMessage:(NSMutableDictionary *)message
+{
+}
+
+- (id)meshController:(HYPMeshController *)meshController
+alternateInstanceForLostInstance:(id)instance
+{
+    return nil;
+}
+
+@end
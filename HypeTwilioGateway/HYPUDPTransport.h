@@ -0,0 +1,90 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPTransport.h"
+
+/**
+ * @abstract UDP transport.
+ * @discussion This class implements the transport on top of UDP, so that
+ * the bridge can be run and load tested without the Hype framework. Peers
+ * are "host:port" strings. A peer is found when the first datagram arrives
+ * from it and lost when nothing arrives for the peer timeout; every data
+ * datagram is acknowledged so that delivery notifications mean the same as
+ * with Hype, and duplicated datagrams are recognized by their sequence number
+ * and delivered once. Several transports may bind the same port, in which case the
+ * kernel spreads remote peers across them. All notifications are issued on
+ * the queue given at initialization.
+ */
+@interface HYPUDPTransport : NSObject <HYPTransport>
+
+@property (atomic, weak) id<HYPTransportDelegate> delegate;
+
+/**
+ * @abstract Queue given at initialization.
+ */
+@property (atomic, readonly) dispatch_queue_t queue;
+
+/**
+ * @abstract Probability of dropping an outgoing datagram.
+ * @discussion This simulates a lossy link. The default is zero.
+ */
+@property (atomic) double lossRate;
+
+/**
+ * @abstract Number carried by hellos.
+ * @discussion Peers forget the sequence numbers they received from this
+ * end when it changes, which is how they notice a restart. It is random by
+ * default; transports sharing a port must be given the same one, since a
+ * peer may be greeted by one of them and answered by another.
+ */
+@property (atomic) uint32_t session;
+
+/**
+ * @abstract Silence after which a peer is considered lost.
+ */
+@property (atomic) NSTimeInterval peerTimeout;
+
+@property (atomic, readonly) NSUInteger sentDatagrams;
+@property (atomic, readonly) NSUInteger receivedDatagrams;
+@property (atomic, readonly) NSUInteger peerCount;
+
+/**
+ * @abstract Initializer.
+ * @discussion Initializes a transport that listens on the given port.
+ * @param port UDP port to bind.
+ * @param queue Queue on which notifications are issued.
+ */
+- (instancetype)initWithPort:(uint16_t)port
+                       queue:(dispatch_queue_t)queue;
+
+/**
+ * @abstract Adds a peer to greet on start.
+ * @discussion Peers that are not added are found when they greet this transport.
+ * @param address Peer address, as "host:port".
+ */
+- (void)addPeerWithAddress:(NSString *)address;
+
+@end
@@ -0,0 +1,449 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import "HYPUDPTransport.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Every datagram starts with a kind byte and a sequence number in network
+// byte order. Data datagrams carry one frame and are answered by an ack
+// holding the same sequence number; hellos keep peers alive.
+static const uint8_t HYPDatagramHello = 'H';
+static const uint8_t HYPDatagramData = 'D';
+static const uint8_t HYPDatagramAck = 'A';
+static const size_t HYPDatagramHeaderLength = 5;
+static const size_t HYPDatagramMaximumLength = 65507;
+
+// Number of sequence numbers below the highest one received from a peer
+// that are remembered for deduplication. Older ones are dropped.
+static const uint32_t HYPDatagramDuplicateWindow = 4096;
+
+@interface HYPUDPTransport ()
+
+@property (atomic, readonly) uint16_t port;
+@property (atomic) int fileDescriptor;
+@property (atomic) dispatch_source_t readSource;
+@property (atomic) dispatch_source_t keepAliveTimer;
+@property (strong, atomic, readonly) NSMutableData * buffer;
+@property (strong, atomic, readonly) NSMutableSet * staticPeers;
+@property (strong, atomic, readonly) NSMutableDictionary * lastSeenDates;
+@property (strong, atomic, readonly) NSMutableDictionary * socketAddresses;
+@property (strong, atomic, readonly) NSMutableDictionary * sessions;
+@property (strong, atomic, readonly) NSMutableDictionary * receivedSequences;
+@property (atomic) uint32_t lastSequence;
+@property (atomic, readwrite) NSUInteger sentDatagrams;
+@property (atomic, readwrite) NSUInteger receivedDatagrams;
+@property (atomic, readwrite) NSUInteger peerCount;
+
+@end
+
+@implementation HYPUDPTransport
+@synthesize port = _port;
+@synthesize queue = _queue;
+@synthesize buffer = _buffer;
+@synthesize staticPeers = _staticPeers;
+@synthesize lastSeenDates = _lastSeenDates;
+@synthesize socketAddresses = _socketAddresses;
+@synthesize sessions = _sessions;
+@synthesize receivedSequences = _receivedSequences;
+
+- (instancetype)initWithPort:(uint16_t)port
+                       queue:(dispatch_queue_t)queue
+{
+    self = [super init];
+    
+    if (self) {
+        
+        _port = port;
+        _queue = queue;
+        _fileDescriptor = -1;
+        _peerTimeout = 30.0;
+        _buffer = [NSMutableData dataWithLength:HYPDatagramMaximumLength];
+        _staticPeers = [NSMutableSet new];
+        _lastSeenDates = [NSMutableDictionary new];
+        _socketAddresses = [NSMutableDictionary new];
+        _sessions = [NSMutableDictionary new];
+        _receivedSequences = [NSMutableDictionary new];
+        
+        uuid_t bytes;
+        [[NSUUID UUID] getUUIDBytes:bytes];
+        memcpy(&_session, bytes, sizeof(_session));
+        _session |= 1;
+    }
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_keepAliveTimer != nil) {
+        dispatch_source_cancel(_keepAliveTimer);
+    }
+    
+    if (_readSource != nil) {
+        dispatch_source_cancel(_readSource);
+    }
+}
+
+- (void)addPeerWithAddress:(NSString *)address
+{
+    dispatch_async(self.queue, ^{
+        [self.staticPeers addObject:address];
+    });
+}
+
+#pragma mark - Transport
+
+- (void)start
+{
+    dispatch_async(self.queue, ^{
+        [self open];
+    });
+}
+
+- (void)open
+{
+    int fileDescriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    
+    if (fileDescriptor < 0) {
+        NSLog(@"UDP transport failed to create socket [%s]", strerror(errno));
+        return;
+    }
+    
+    int enable = 1;
+    setsockopt(fileDescriptor, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+#ifdef SO_REUSEPORT
+    // Lets one transport per core bind the same port; the kernel then hashes
+    // each remote address to one of them, so a peer always lands on the
+    // same event loop.
+    setsockopt(fileDescriptor, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+#endif
+    fcntl(fileDescriptor, F_SETFL, fcntl(fileDescriptor, F_GETFL, 0) | O_NONBLOCK);
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(self.port);
+    
+    if (bind(fileDescriptor, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        NSLog(@"UDP transport failed to bind port %u [%s]", self.port, strerror(errno));
+        close(fileDescriptor);
+        return;
+    }
+    
+    self.fileDescriptor = fileDescriptor;
+    
+    __weak HYPUDPTransport * weakSelf = self;
+    
+    dispatch_source_t readSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, fileDescriptor, 0, self.queue);
+    dispatch_source_set_event_handler(readSource, ^{
+        [weakSelf readDatagrams];
+    });
+    dispatch_source_set_cancel_handler(readSource, ^{
+        close(fileDescriptor);
+    });
+    dispatch_resume(readSource);
+    self.readSource = readSource;
+    
+    uint64_t interval = (uint64_t)(self.peerTimeout * NSEC_PER_SEC / 3);
+    dispatch_source_t keepAliveTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.queue);
+    dispatch_source_set_timer(keepAliveTimer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, NSEC_PER_SEC);
+    dispatch_source_set_event_handler(keepAliveTimer, ^{
+        [weakSelf keepAlive];
+    });
+    dispatch_resume(keepAliveTimer);
+    self.keepAliveTimer = keepAliveTimer;
+    
+    [self keepAlive];
+}
+
+- (NSUInteger)sendData:(NSData *)data
+                toPeer:(id)peer
+{
+    uint32_t sequence;
+    
+    @synchronized(self) {
+        sequence = ++_lastSequence;
+    }
+    
+    if (data.length + HYPDatagramHeaderLength > HYPDatagramMaximumLength
+        || ![self sendDatagramOfKind:HYPDatagramData sequence:sequence payload:data toPeer:peer]) {
+        
+        dispatch_async(self.queue, ^{
+            [self.delegate transport:self didFailSendingMessageWithIdentifier:sequence];
+        });
+    }
+    
+    return sequence;
+}
+
+- (NSString *)identifierForPeer:(id)peer
+{
+    return peer;
+}
+
+#pragma mark - Datagrams
+
+- (BOOL)sendDatagramOfKind:(uint8_t)kind
+                  sequence:(uint32_t)sequence
+                   payload:(NSData *)payload
+                    toPeer:(NSString *)peer
+{
+    NSData * socketAddress = [self socketAddressForPeer:peer];
+    
+    if (socketAddress == nil || self.fileDescriptor < 0) {
+        return NO;
+    }
+    
+    self.sentDatagrams += 1;
+    
+    if (self.lossRate > 0 && drand48() < self.lossRate) {
+        // Lost on the simulated link.
+        return YES;
+    }
+    
+    uint32_t networkSequence = htonl(sequence);
+    NSMutableData * datagram = [NSMutableData dataWithCapacity:HYPDatagramHeaderLength + payload.length];
+    [datagram appendBytes:&kind length:1];
+    [datagram appendBytes:&networkSequence length:4];
+    
+    if (payload != nil) {
+        [datagram appendData:payload];
+    }
+    
+    ssize_t written = sendto(self.fileDescriptor,
+                             datagram.bytes,
+                             datagram.length,
+                             0,
+                             socketAddress.bytes,
+                             (socklen_t)socketAddress.length);
+    
+    return written == (ssize_t)datagram.length;
+}
+
+- (void)readDatagrams
+{
+    uint8_t * bytes = self.buffer.mutableBytes;
+    
+    for (;;) {
+        
+        struct sockaddr_in address;
+        socklen_t addressLength = sizeof(address);
+        ssize_t length = recvfrom(self.fileDescriptor,
+                                  bytes,
+                                  HYPDatagramMaximumLength,
+                                  0,
+                                  (struct sockaddr *)&address,
+                                  &addressLength);
+        
+        if (length < 0) {
+            // Drained; the read source fires again when more arrive.
+            break;
+        }
+        
+        if ((size_t)length < HYPDatagramHeaderLength) {
+            continue;
+        }
+        
+        self.receivedDatagrams += 1;
+        
+        NSString * peer = [self peerWithSocketAddress:&address];
+        uint8_t kind = bytes[0];
+        uint32_t sequence;
+        memcpy(&sequence, bytes + 1, 4);
+        sequence = ntohl(sequence);
+        
+        [self touchPeer:peer];
+        
+        if (kind == HYPDatagramHello) {
+            
+            [self peer:peer didGreetWithSession:sequence];
+            
+        } else if (kind == HYPDatagramData) {
+            
+            // A duplicate is acknowledged again, since the first ack may be
+            // the one that got lost, but it is not delivered twice.
+            [self sendDatagramOfKind:HYPDatagramAck sequence:sequence payload:nil toPeer:peer];
+            
+            if (![self acceptSequence:sequence fromPeer:peer]) {
+                continue;
+            }
+            
+            NSData * data = [NSData dataWithBytes:bytes + HYPDatagramHeaderLength
+                                           length:length - HYPDatagramHeaderLength];
+            [self.delegate transport:self didReceiveData:data fromPeer:peer];
+            
+        } else if (kind == HYPDatagramAck) {
+            
+            [self.delegate transport:self didDeliverMessageWithIdentifier:sequence];
+        }
+    }
+}
+
+#pragma mark - Deduplication
+
+- (void)peer:(NSString *)peer didGreetWithSession:(uint32_t)session
+{
+    NSNumber * lastSession = [self.sessions objectForKey:peer];
+    
+    // Older versions greet with zero, which never resets anything.
+    if (session == 0 || lastSession.unsignedIntValue == session) {
+        return;
+    }
+    
+    [self.sessions setObject:@(session) forKey:peer];
+    
+    if (lastSession != nil) {
+        [self.receivedSequences removeObjectForKey:peer];
+    }
+}
+
+- (BOOL)acceptSequence:(uint32_t)sequence fromPeer:(NSString *)peer
+{
+    NSMutableIndexSet * sequences = [self.receivedSequences objectForKey:peer];
+    
+    if (sequences == nil) {
+        sequences = [NSMutableIndexSet new];
+        [self.receivedSequences setObject:sequences forKey:peer];
+    }
+    
+    NSUInteger highest = sequences.count > 0 ? sequences.lastIndex : 0;
+    
+    if ([sequences containsIndex:sequence]
+        || (highest > HYPDatagramDuplicateWindow && sequence <= highest - HYPDatagramDuplicateWindow)) {
+        return NO;
+    }
+    
+    [sequences addIndex:sequence];
+    
+    // Datagrams arrive roughly in order, so the set stays a few ranges wide
+    // once the sequences below the window are forgotten.
+    if (sequences.lastIndex > HYPDatagramDuplicateWindow) {
+        [sequences removeIndexesInRange:NSMakeRange(0, sequences.lastIndex - HYPDatagramDuplicateWindow + 1)];
+    }
+    
+    return YES;
+}
+
+#pragma mark - Peers
+
+- (void)touchPeer:(NSString *)peer
+{
+    BOOL found = [self.lastSeenDates objectForKey:peer] == nil;
+    
+    [self.lastSeenDates setObject:[NSDate date] forKey:peer];
+    
+    if (found) {
+        
+        self.peerCount = self.lastSeenDates.count;
+        
+        // Greeting back lets a peer that only sent data find this end too.
+        [self sendDatagramOfKind:HYPDatagramHello sequence:self.session payload:nil toPeer:peer];
+        [self.delegate transport:self didFindPeer:peer];
+    }
+}
+
+- (void)keepAlive
+{
+    NSDate * deadline = [NSDate dateWithTimeIntervalSinceNow:-self.peerTimeout];
+    
+    for (NSString * peer in [self.lastSeenDates allKeys]) {
+        
+        if ([[self.lastSeenDates objectForKey:peer] compare:deadline] == NSOrderedAscending) {
+            
+            [self.lastSeenDates removeObjectForKey:peer];
+            [self.receivedSequences removeObjectForKey:peer];
+            [self.sessions removeObjectForKey:peer];
+            self.peerCount = self.lastSeenDates.count;
+            [self.delegate transport:self didLosePeer:peer];
+        }
+    }
+    
+    NSMutableSet * peers = [NSMutableSet setWithArray:[self.lastSeenDates allKeys]];
+    [peers unionSet:self.staticPeers];
+    
+    for (NSString * peer in peers) {
+        [self sendDatagramOfKind:HYPDatagramHello sequence:self.session payload:nil toPeer:peer];
+    }
+}
+
+- (NSString *)peerWithSocketAddress:(const struct sockaddr_in *)address
+{
+    char host[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &address->sin_addr, host, sizeof(host));
+    
+    NSString * peer = [NSString stringWithFormat:@"%s:%u", host, ntohs(address->sin_port)];
+    
+    @synchronized(self.socketAddresses) {
+        
+        if ([self.socketAddresses objectForKey:peer] == nil) {
+            [self.socketAddresses setObject:[NSData dataWithBytes:address length:sizeof(*address)] forKey:peer];
+        }
+    }
+    
+    return peer;
+}
+
+- (NSData *)socketAddressForPeer:(NSString *)peer
+{
+    @synchronized(self.socketAddresses) {
+        
+        NSData * socketAddress = [self.socketAddresses objectForKey:peer];
+        
+        if (socketAddress != nil) {
+            return socketAddress;
+        }
+        
+        NSRange separator = [peer rangeOfString:@":" options:NSBackwardsSearch];
+        
+        if (separator.location == NSNotFound) {
+            return nil;
+        }
+        
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons((uint16_t)[[peer substringFromIndex:separator.location + 1] intValue]);
+        
+        if (inet_pton(AF_INET, [[peer substringToIndex:separator.location] UTF8String], &address.sin_addr) != 1) {
+            return nil;
+        }
+        
+        socketAddress = [NSData dataWithBytes:&address length:sizeof(address)];
+        [self.socketAddresses setObject:socketAddress forKey:peer];
+        
+        return socketAddress;
+    }
+}
+
+@end
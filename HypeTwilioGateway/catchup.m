@@ -0,0 +1,66 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPCatchUpSimulation.h"
+
+// Options are read from the argument domain of the user defaults, so they
+// are given as "-history 100000 -gap 1000 -loss 0.05 -seed 42 -port 7900
+// -timeout 60".
+int main(int argc, char * argv[]) {
+    // Declared outside the pool so that it lives while the main queue runs.
+    HYPCatchUpSimulation * simulation;
+    
+    @autoreleasepool {
+        
+        NSUserDefaults * defaults = [NSUserDefaults standardUserDefaults];
+        simulation = [[HYPCatchUpSimulation alloc] init];
+        
+        if ([defaults objectForKey:@"history"] != nil) {
+            simulation.historyCount = (NSUInteger)[defaults integerForKey:@"history"];
+        }
+        
+        if ([defaults objectForKey:@"gap"] != nil) {
+            simulation.gapCount = (NSUInteger)[defaults integerForKey:@"gap"];
+        }
+        
+        if ([defaults objectForKey:@"port"] != nil) {
+            simulation.port = (uint16_t)[defaults integerForKey:@"port"];
+        }
+        
+        if ([defaults objectForKey:@"timeout"] != nil) {
+            simulation.timeout = [defaults doubleForKey:@"timeout"];
+        }
+        
+        simulation.lossRate = [defaults doubleForKey:@"loss"];
+        simulation.seed = (uint64_t)[defaults integerForKey:@"seed"];
+        
+        [simulation startWithCompletion:^(BOOL caughtUp) {
+            exit(caughtUp ? 0 : 1);
+        }];
+    }
+    
+    dispatch_main();
+}
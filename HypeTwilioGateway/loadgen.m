@@ -0,0 +1,75 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPLoadGenerator.h"
+
+// Options are read from the argument domain of the user defaults, so they
+// are given as "-gateway 127.0.0.1:7878 -peers 100 -messages 50 -rate 2
+// -loss 0.05 -seed 42 -stats 5 -duration 300 -burst YES".
+int main(int argc, char * argv[]) {
+    // Declared outside the pool so that it lives while the main queue runs.
+    HYPLoadGenerator * generator;
+    
+    @autoreleasepool {
+        
+        NSUserDefaults * defaults = [NSUserDefaults standardUserDefaults];
+        generator = [[HYPLoadGenerator alloc] init];
+        
+        if ([defaults stringForKey:@"gateway"] != nil) {
+            generator.gatewayAddress = [defaults stringForKey:@"gateway"];
+        }
+        
+        if ([defaults objectForKey:@"peers"] != nil) {
+            generator.peerCount = (NSUInteger)[defaults integerForKey:@"peers"];
+        }
+        
+        if ([defaults objectForKey:@"messages"] != nil) {
+            generator.messageCount = (NSUInteger)[defaults integerForKey:@"messages"];
+        }
+        
+        if ([defaults objectForKey:@"rate"] != nil) {
+            generator.rate = [defaults doubleForKey:@"rate"];
+        }
+        
+        if ([defaults objectForKey:@"stats"] != nil) {
+            generator.statisticsInterval = [defaults doubleForKey:@"stats"];
+        }
+        
+        if ([defaults objectForKey:@"duration"] != nil) {
+            generator.duration = [defaults doubleForKey:@"duration"];
+        }
+        
+        generator.burst = [defaults boolForKey:@"burst"];
+        generator.lossRate = [defaults doubleForKey:@"loss"];
+        generator.seed = (uint64_t)[defaults integerForKey:@"seed"];
+        
+        [generator startWithCompletion:^{
+            exit(0);
+        }];
+    }
+    
+    dispatch_main();
+}
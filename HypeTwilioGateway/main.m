@@ -0,0 +1,69 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPGatewayDaemon.h"
+
+// Options are read from the argument domain of the user defaults, so they
+// are given as "-port 7878 -shards 4 -peers 10.0.0.2:7878,10.0.0.3:7878
+// -loss 0.05 -stats 10 -store /var/lib/hype-gateway/messages.log -seed 42
+// -history 10000".
+int main(int argc, char * argv[]) {
+    // Declared outside the pool so that it lives while the main queue runs.
+    HYPGatewayDaemon * daemon;
+    
+    @autoreleasepool {
+        
+        NSUserDefaults * defaults = [NSUserDefaults standardUserDefaults];
+        daemon = [[HYPGatewayDaemon alloc] init];
+        
+        if ([defaults objectForKey:@"port"] != nil) {
+            daemon.port = (uint16_t)[defaults integerForKey:@"port"];
+        }
+        
+        if ([defaults objectForKey:@"shards"] != nil) {
+            daemon.shardCount = (NSUInteger)[defaults integerForKey:@"shards"];
+        }
+        
+        if ([defaults objectForKey:@"stats"] != nil) {
+            daemon.statisticsInterval = [defaults doubleForKey:@"stats"];
+        }
+        
+        daemon.lossRate = [defaults doubleForKey:@"loss"];
+        daemon.seed = (uint64_t)[defaults integerForKey:@"seed"];
+        daemon.historyCount = (NSUInteger)[defaults integerForKey:@"history"];
+        daemon.storePath = [defaults stringForKey:@"store"];
+        
+        NSString * peers = [defaults stringForKey:@"peers"];
+        
+        if (peers.length > 0) {
+            daemon.peerAddresses = [peers componentsSeparatedByString:@","];
+        }
+        
+        [daemon start];
+    }
+    
+    dispatch_main();
+}
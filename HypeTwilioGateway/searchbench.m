@@ -0,0 +1,60 @@
+//
+// MIT License
+//
+// Copyright (C) 2015 Twilio Inc.
+// Copyright (C) 2018 HypeLabs Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "HYPSearchBenchmark.h"
+
+// Options are read from the argument domain of the user defaults, so they
+// are given as "-messages 1000000 -queries 1000 -limit 100 -seed 42".
+int main(int argc, char * argv[]) {
+    // Declared outside the pool so that it lives while the main queue runs.
+    HYPSearchBenchmark * benchmark;
+    
+    @autoreleasepool {
+        
+        NSUserDefaults * defaults = [NSUserDefaults standardUserDefaults];
+        benchmark = [[HYPSearchBenchmark alloc] init];
+        
+        if ([defaults objectForKey:@"messages"] != nil) {
+            benchmark.messageCount = (NSUInteger)[defaults integerForKey:@"messages"];
+        }
+        
+        if ([defaults objectForKey:@"queries"] != nil) {
+            benchmark.queryCount = (NSUInteger)[defaults integerForKey:@"queries"];
+        }
+        
+        if ([defaults objectForKey:@"limit"] != nil) {
+            benchmark.limit = (NSUInteger)[defaults integerForKey:@"limit"];
+        }
+        
+        benchmark.seed = (uint64_t)[defaults integerForKey:@"seed"];
+        
+        [benchmark startWithCompletion:^{
+            exit(0);
+        }];
+    }
+    
+    dispatch_main();
+}